@@ -0,0 +1,70 @@
+#pragma once
+
+#include <switch.h>
+
+#include "folder_owners.h"
+#include "fs_path.h"
+#include "path_hash_set.h"
+
+#include <memory>
+#include <string_view>
+
+/**
+ * Index of the files & folders in the game's Atmosphere folder, built with one walk through it,
+ * so conflicts can be checked without a filesystem call for every file
+ * 
+ * Paths are relative to the game's Atmosphere folder (starting with a '/').
+ * The contents of folders that a mod moved there as a whole (see FolderOwners) aren't indexed,
+ * since nothing is added to them until they're split up.
+ * 
+ * Only 64-bit hashes of the paths are kept (within ATMOSPHERE_INDEX_MEMORY). Two paths in one game's folder
+ * having the same hash is unlikely enough that the index's answer is taken as it is, without asking the filesystem.
+ * If the folder holds more than fits, every check goes to the filesystem instead.
+ * 
+ * The memory is only taken from `build()` until `clear()`, which the controller calls once a run of activations is done
+ * (a random draw or profile, or leaving the mods menu), so it isn't held while nothing is being moved.
+ */
+class AtmosphereIndex {
+  public:
+    AtmosphereIndex();
+
+    /**
+     * Walks through the Atmosphere folder, indexing everything in it
+     */
+    void build(const FsPath& atmospherePath, const FolderOwners& owners);
+
+    /**
+     * Forgets everything indexed, freeing its memory (the next `build()` starts from scratch)
+     */
+    void clear();
+
+    bool isBuilt() const;
+
+    bool contains(std::string_view path, bool isFolder) const;
+
+    /**
+     * Keep the index up to date as files & folders are moved in and out
+     * 
+     * Does nothing if the index hasn't been built
+     */
+    void add(std::string_view path, bool isFolder);
+    void remove(std::string_view path, bool isFolder);
+
+  private:
+    bool built;
+
+    // Whether everything in the folder fit in the index:
+    bool complete;
+
+    FsPath atmospherePath;
+
+    // Folders are hashed with a trailing '/' (only allocated while built):
+    std::unique_ptr<PathHashSet> paths;
+
+    static u64 toKey(std::string_view path, bool isFolder);
+
+    /**
+     * Checks the filesystem for the path (only used when the index can't answer)
+     */
+    bool exists(std::string_view path, bool isFolder) const;
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <switch.h>
+
+#include "fs_path.h"
+
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Everything in a game's Mod Alchemist folder (groups, sources, mods, ratings, locks & active mods),
+ * so screens don't need to walk through the folder again every time they're opened
+ *
+ * Groups, sources & mods are each identified by an ID, which is their index in the catalog's arrays.
+ * Each group's sources (and each source's mods) have consecutive IDs, in order of their names.
+ * IDs stay the same until the catalog is built again.
+ *
+ * Every name is stored once in a single pool of text (a name is part of its folder name, so it isn't stored separately).
+ *
+ * Saved as a single binary file (see CATALOG_NAME) that's read all at once.
+ * The active mods are saved in a separate small file (see ACTIVE_MODS_NAME), since they change much more often.
+ */
+class Catalog {
+  public:
+    // ID for when there's no group/source/mod:
+    static const u32 NONE = 0xFFFFFFFF;
+
+    typedef std::ranges::iota_view<u32, u32> IdRange;
+
+    /**
+     * Reads the catalog from the file
+     *
+     * Returns false if there's no file or it can't be read (in which case the catalog is left empty)
+     */
+    bool load(const FsPath& path);
+
+    void save(const FsPath& path) const;
+
+    /**
+     * Reads the active mods from the file
+     * 
+     * Returns false if there's no file, it can't be read, or it was saved for a different build of the catalog
+     * (in which case no mods are left active)
+     */
+    bool loadActiveMods(const FsPath& path);
+
+    void saveActiveMods(const FsPath& path) const;
+
+    /**
+     * Reads the ratings & locks changed in the overlay, which take the place of what the folders' names say
+     * 
+     * Records for folders that have since been renamed (or removed) are ignored
+     */
+    void loadMetadata(const FsPath& path);
+
+    /**
+     * Saves every rating & lock that's different from what its folder's name says, all in one write
+     */
+    void saveMetadata(const FsPath& path) const;
+
+    /**
+     * Finds the active mods again from the lists of moved files in each source's folder
+     * (without cataloging anything else again)
+     */
+    void findActiveMods(const FsPath& gamePath);
+
+    /**
+     * Walks through the game's folder to catalog everything in it from scratch
+     */
+    void build(const FsPath& gamePath);
+
+    /**
+     * Catalogs the game's folder again like `build()`, but only counts the files of mods that weren't in the catalog before
+     * (mods that were keep their file counts, even if their folders were renamed)
+     */
+    void update(const FsPath& gamePath);
+
+    /**
+     * Checks if the game's folder still has the same groups, and the same entries in each group & source
+     *
+     * Only folders modified since they were cataloged are read, comparing a hash of the names in them, so renaming
+     * something (such as editing a rating on a PC) is noticed too. What's inside mods' folders isn't checked.
+     * Changes made by Mod Alchemist itself are kept in the catalog as they're made.
+     *
+     * A folder that was modified without anything in it changing gets its new time recorded, so it isn't read again
+     * (timesUpdated is set if that happens, in which case the catalog should be saved).
+     */
+    bool isCurrent(const FsPath& gamePath, bool& timesUpdated);
+
+    IdRange groups() const;
+    IdRange sourcesOf(u32 group) const;
+    IdRange modsOf(u32 source) const;
+
+    /**
+     * Finds an ID by name (returns NONE if there isn't one)
+     */
+    u32 findGroup(std::string_view name) const;
+    u32 findSource(u32 group, std::string_view name) const;
+    u32 findMod(u32 source, std::string_view name) const;
+
+    std::string_view groupName(u32 group) const;
+
+    std::string_view sourceName(u32 source) const;
+    std::string_view sourceFolderName(u32 source) const;
+    u8 sourceRating(u32 source) const; // Rating for using no mod
+    bool isSourceLocked(u32 source) const;
+
+    /**
+     * Gets the mod that's active for the source (NONE if no mod is active)
+     */
+    u32 activeMod(u32 source) const;
+
+    /**
+     * Checks if the active mod's list of moved files is in the legacy text format (from an activation by an older version)
+     */
+    bool hasLegacyList(u32 source) const;
+
+    std::string_view modName(u32 mod) const;
+    std::string_view modFolderName(u32 mod) const;
+    u8 modRating(u32 mod) const;
+
+    /**
+     * Number of files in the mod
+     *
+     * If the mod was already active when it was counted, this is the number of
+     * files & folders in its list of moved files instead (folders moved as a whole count as 1)
+     */
+    u32 modFileCount(u32 mod) const;
+
+    /**
+     * Changes a rating/lock without renaming anything (saved with `saveMetadata()`)
+     */
+    void setSourceRating(u32 source, u8 rating);
+    void setSourceLocked(u32 source, bool locked);
+    void setModRating(u32 mod, u8 rating);
+
+    /**
+     * Keep the active mods up to date as mods are activated (or deactivated with NONE)
+     * 
+     * Mods activated now always get a list in the binary format
+     */
+    void setActiveMod(u32 source, u32 mod);
+
+  private:
+    // A piece of text in the pool:
+    struct PoolText {
+      u32 offset;
+      u16 length;
+    };
+
+    std::string pool;
+
+    // Changes every time the catalog is built (the whole system tick), so the active mods can tell if they were saved for this build:
+    u64 generation = 0;
+
+    // Groups:
+    std::vector<PoolText> groupNames;
+    std::vector<u64> groupListingHashes; // Hash of the folders in the group's folder when it was last cataloged (see `hashEntryName()`)
+    std::vector<u64> groupModifiedTimes; // When the group's folder was modified as of then (0 if it couldn't be read)
+    std::vector<u32> groupFirstSources;
+
+    // Sources:
+    std::vector<PoolText> sourceFolderNames;
+    std::vector<PoolText> sourceNames;
+    std::vector<u8> sourceRatings;
+    std::vector<u8> sourceLocks;
+    std::vector<u32> sourceActiveMods;
+    std::vector<u8> sourceLegacyLists; // See `hasLegacyList()`
+    // Hash of the folders & files in the source's folder when it was last cataloged (not counting the active mod's list of moved files):
+    std::vector<u64> sourceListingHashes;
+    std::vector<u64> sourceModifiedTimes;
+    std::vector<u32> sourceFirstMods;
+
+    // Mods:
+    std::vector<PoolText> modFolderNames;
+    std::vector<PoolText> modNames;
+    std::vector<u8> modRatings;
+    std::vector<u32> modFileCounts;
+
+    void clear();
+
+    std::string_view view(const PoolText& text) const;
+
+    /**
+     * Adds a folder name to the pool, along with the name within it
+     */
+    void storeFolderName(std::string_view folderName, PoolText& folderText, PoolText& nameText);
+
+    /**
+     * Adds an entry after the last one (a source goes in the last group added, and a mod in the last source added)
+     */
+    void addGroup(std::string_view name, u64 listingHash, u64 modifiedTime);
+    void addSource(std::string_view folderName, u64 listingHash, u64 modifiedTime);
+    void addMod(std::string_view folderName, u32 fileCount);
+
+    /**
+     * Catalogs every group in the game's folder, taking the file counts of mods from the previous catalog when it has them
+     */
+    void buildGroups(const FsPath& gamePath, const Catalog* previous);
+
+    /**
+     * Catalogs a source's folder, including the mods in it (previousSource is the same source in the previous catalog, or NONE)
+     */
+    void buildSource(const FsPath& sourcePath, std::string_view folderName, const Catalog* previous, u32 previousSource);
+
+    /**
+     * Checks a folder's listing against its hash, unless the folder hasn't been modified since it was cataloged
+     * (the time is updated if it was modified but the listing is the same)
+     *
+     * @param activeMod The active mod, whose list of moved files isn't part of the hash (NONE for a group's folder)
+     */
+    bool isListingCurrent(const FsPath& path, u32 mode, u32 activeMod, u64 listingHash, u64& modifiedTime, bool& timesUpdated) const;
+
+    /**
+     * Hashes a name in a folder's listing (a listing's hash is the sum of its names' hashes, so the order they're read in doesn't matter)
+     */
+    static u64 hashEntryName(std::string_view name);
+
+    /**
+     * Gets the name of the mod that's active according to the list of moved files, if the entry is one
+     */
+    static bool isMovedFilesList(const FsDirectoryEntry& entry, std::string& mod);
+
+    /**
+     * Counts the files in a mod (or what's in its list of moved files if it's active)
+     */
+    static u32 countModFiles(const FsPath& modPath, const FsPath& movedFilesListPath);
+};
@@ -4,8 +4,36 @@
 #include <switch.h>
 #include <string>
 
-// Small to minimize memory usage
-const s64 FILE_LIST_BUFFER_SIZE = 30;
+// Most of a list of moved files that's read into memory at once (smaller lists are read whole).
+// Must be larger than any single line in the list (FS_MAX_PATH):
+const s64 READ_BUFFER_SIZE = 0x1000;
+
+// Number of directory entries read per IPC call when listing a folder.
+// Each entry is ~0x310 bytes, so this is kept small as well:
+const s64 DIR_READ_BATCH_SIZE = 16;
+
+// Batch size for each folder that's open at once while walking through a mod's folder tree
+// (one buffer is kept for each level of depth):
+const s64 TREE_WALK_BATCH_SIZE = 8;
+
+// Size of the buffer used to write lists of moved files (written & flushed to the SD card 1 block at a time):
+const s64 WRITE_BLOCK_SIZE = 0x1000;
+
+// Stack for the thread that moves files in the background (see Worker).
+// Its priority is just below the overlay's own thread, so drawing the menu always comes first:
+const size_t WORKER_STACK_SIZE = 0x10000;
+const int WORKER_PRIORITY = 0x2D;
+
+// How long a mod being turned on/off in the menu gets to move files each frame, before the menu is drawn again.
+// Higher finishes sooner, lower keeps the menu smoother (a frame is ~16.7ms):
+const u64 JOB_FRAME_BUDGET_NS = 8000000;
+
+// Bytes kept inside each screen for its own containers (see ScreenArena):
+const std::size_t SCREEN_ARENA_SIZE = 0x400;
+
+// Memory for the index of a game's Atmosphere folder (see AtmosphereIndex).
+// Holds hashes of ~12k paths; anything past that falls back to checking the filesystem:
+const std::size_t ATMOSPHERE_INDEX_MEMORY = 0x40000;
 
 // Substring to delimit the rating from the mod name in the folder name:
 const std::string RATING_DELIMITER = "~~";
@@ -13,7 +41,75 @@ const std::string RATING_DELIMITER = "~~";
 // Character at start of a folder name of a source to indicate that it's locked:
 const char LOCKED_CHAR = '~';
 
+// Extension of the list of files moved by an active mod.
+// Lists with TXT_EXT are from older versions, and are still read:
+const std::string MANIFEST_EXT = ".moved";
+
+// The binary list of moved files starts with these bytes, followed by a version byte.
+// Each path in it is then stored as:
+//   u8 flags (MANIFEST_FOLDER_FLAG if it's a folder)
+//   u16 length of the start of the previous path that this path shares
+//   u16 length of the rest of the path
+//   the rest of the path
+const std::string MANIFEST_MAGIC = "MAML";
+const u8 MANIFEST_VERSION = 1;
+const u8 MANIFEST_FOLDER_FLAG = 1;
+const s64 MANIFEST_RECORD_HEADER_SIZE = 5;
+
 const std::string TXT_EXT = ".txt";
+
+// Name of the file in the game's folder that catalogs everything in it (see Catalog).
+// It starts with CATALOG_MAGIC followed by a version byte:
+const std::string CATALOG_NAME = ".catalog";
+const std::string CATALOG_MAGIC = "MACA";
+const u8 CATALOG_VERSION = 5;
+
+// Name of the file in the game's folder with the active mod of each source in the catalog.
+// It's kept apart from the catalog so it can be rewritten on every activation without rewriting the whole catalog.
+// After ACTIVE_MODS_MAGIC and a version byte, it has the catalog's u64 generation, a u32 number of sources,
+// then for each source a u16 with the position of its active mod among its mods (ACTIVE_MODS_NONE if none is active)
+// and a u8 that's 1 if that mod's list of moved files is in the legacy text format:
+const std::string ACTIVE_MODS_NAME = ".active";
+const std::string ACTIVE_MODS_MAGIC = "MAAT";
+const u8 ACTIVE_MODS_VERSION = 3;
+const u16 ACTIVE_MODS_NONE = 0xFFFF;
+
+// Name of the file in the game's folder with ratings & locks that were changed in the overlay.
+// Each record is only kept while its value differs from what the folder's name says (see MetaManager),
+// and is keyed by the folder's name, so renaming the folder by hand goes back to reading the folder's name.
+// After METADATA_MAGIC and a version byte, it has a u32 number of records, each of which is:
+//   u8 kind (METADATA_SOURCE or METADATA_MOD)
+//   the group's name, the source's folder name (or name for a mod), and the mod's folder name (only for a mod),
+//   each as a u16 length followed by the text
+//   u8 rating
+//   u8 locked (only for a source)
+const std::string METADATA_NAME = ".meta";
+const std::string METADATA_MAGIC = "MAMD";
+const u8 METADATA_VERSION = 1;
+const u8 METADATA_SOURCE = 0;
+const u8 METADATA_MOD = 1;
+
+// Name of the file in the game's folder with the saved profiles (see ProfileList).
+// It's text, so profiles can be renamed on a PC. Each profile starts with a line with its name in brackets,
+// followed by a line for each source: "group/source/mod" (with nothing after the last '/' for using no mod):
+const std::string PROFILES_NAME = ".profiles";
+
+// Added to the name of a file while its replacement is being written (see FsManager::replaceFile()):
+const std::string REPLACEMENT_EXT = ".new";
+
+// Name of the file in the game's folder that records an activation/return while it's in progress,
+// so it can be finished the next time the overlay is opened if it was interrupted.
+// It has the mod's folder, its list of moved files, then the hash of those two lines (one per line),
+// so a journal that was cut off while being written is ignored:
+const std::string JOURNAL_NAME = ".journal";
+
+// Name of the file in the game's folder that names the mod each folder moved into Atmosphere's folder as a whole belongs to
+// (see FolderOwners). Each record is 4 lines: the folder's path within the game's Atmosphere folder, then the group, source & mod:
+const std::string FOLDER_OWNERS_NAME = ".owners";
+
+// Name of the file in ALCHEMIST_PATH that diagnostics are saved to (only in builds with diagnostics):
+const std::string DIAGNOSTICS_NAME = "diagnostics.txt";
+
 const std::string ALCHEMIST_PATH = "/mod_alchemy/";
 const std::string ATMOSPHERE_PATH = "/atmosphere/contents/";
 
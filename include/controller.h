@@ -2,16 +2,29 @@
 
 #include <switch.h>
 
+#include "atmosphere_index.h"
+#include "catalog.h"
+#include "folder_owners.h"
+#include "fs_manager.h"
+#include "fs_path.h"
+#include "job.h"
+#include "profiles.h"
+#include "random_plan.h"
+#include "worker.h"
+
 #include <vector>
 #include <map>
+#include <memory_resource>
 #include <string>
-#include <ctime>
+#include <string_view>
 
 class Controller {
   public:
     u64 titleId; // The current Game's Title ID
-    std::string group;
-    std::string source;
+
+    // IDs in the catalog of the group & source being viewed:
+    u32 group = Catalog::NONE;
+    u32 source = Catalog::NONE;
 
     void init();
 
@@ -22,104 +35,111 @@ class Controller {
 
     bool doesGameHaveFolder();
 
-    // NOTE: vectors returned from functions in controller
-    // are implied to be sorted alphabetically unless stated otherwise
-
-    /*
-     * Load all groups from the game folder
+    /**
+     * Catalogs the game's folder again from scratch
      * 
-     * @param sort Whether to sort the list of names alphabetically or not
-     *             Can take considerable performance when in nested loops, so sometimes it's good to skip if not needed
+     * Only needed for changes made outside of Mod Alchemist inside mods' folders (such as adding files to a mod), which aren't checked when the catalog is loaded
      */
-    std::vector<std::string> loadGroups(bool sort);
+    void rescan();
 
-    /*
-     * Load all source options within the specified group
-     * 
-     * @param sort Whether to sort the list of names alphabetically or not
-     *             Can take considerable performance when in nested loops, so sometimes it's good to skip if not needed
+    /**
+     * Gets the catalog of everything in the game's folder
      */
-    std::vector<std::string> loadSources(bool sort);
+    const Catalog& getCatalog();
 
-    /*
-     * Gets a vector of only the sources that are unlocked
+    /**
+     * Gets the game's saved profiles (see ProfileList)
      */
-    std::vector<std::string> loadUnlockedSources();
+    const ProfileList& getProfiles();
 
-    /*
-     * Checks if the source is locked from randomization
+    /**
+     * Saves the mods that are active now as a new profile
      */
-    bool isSourceLocked(const std::string& source);
+    void addProfile();
 
-    /*
-     * Load all source options within the specified group along with their lock status
+    /**
+     * Replaces the profile's mods with the ones that are active now
      */
-    std::map<std::string, bool> loadSourceLocks();
+    void updateProfile(u32 profile);
+
+    void deleteProfile(u32 profile);
+
+    /**
+     * Fills the plan with the changes for the profile's mods to be active, only for the sources that differ from it
+     * 
+     * The plan is emptied first, so the same one can be reused for each profile
+     */
+    void planProfile(u32 profile, RandomPlan& plan);
 
     /*
      * Enable/disable randomization for the specified source
      */
-    void lockSource(const std::string& source);
-    void unlockSource(const std::string& source);
+    void lockSource(u32 source);
+    void unlockSource(u32 source);
 
     /*
-     * Load all mod options that could be activated for the moddable source in the group
+     * Saves the ratings for each mod, along with the rating for using no mod for the current source
      * 
-     * @param sort Whether to sort the list of names alphabetically or not
-     *             Can take considerable performance when in nested loops, so sometimes it's good to skip if not needed
+     * Nothing is written unless one of them changed
      */
-    std::vector<std::string> loadMods(bool sort);
+    void saveRatings(const std::pmr::map<u32, u8>& ratings, u8 defaultRating);
 
     /*
-     * Loads map of mods names to each rating
+     * Activates the specified mod, moving all its files into the atmosphere folder for the game
      */
-    std::map<std::string, u8> loadRatings();
+    void activateMod(u32 mod);
 
-    /*
-     * Loads the rating for the source (for using no mod)
+    /**
+     * Same as `activateMod()`, except it pauses after each entry in the mod's folder & each file/folder moved
      */
-    u8 loadDefaultRating(const std::string& source);
+    Job activateModJob(u32 mod);
 
-    /*
-     * Saves the ratings for each mod
+    /**
+     * Deactivates the currently active mod, restoring the moddable source to its vanilla state
      */
-    void saveRatings(const std::map<std::string, u8>& ratings);
+    void deactivateMod();
 
-    /*
-     * Saves the rating for using no mod for the current source
+    /**
+     * Same as `deactivateMod()`, except it pauses after each file/folder moved
      */
-    void saveDefaultRating(const u8& rating);
+    Job deactivateModJob();
 
-    /*
-     * Gets the mod currently activated for the moddable source in the group
-     *
-     * Returns an empty string if no mod is active and vanilla files are being used
+    /**
+     * Deactivates every active mod in the game, going straight to the sources the catalog has an active mod for
+     * 
+     * Progress is counted in sources, and checked for cancelling between them
      */
-    std::string getActiveMod(const std::string& source);
+    void deactivateAll(Progress& progress);
 
-    /*
-     * Activates the specified mod, moving all its files into the atmosphere folder for the game
+    /**
+     * Number of sources in the game that have a mod active
      */
-    void activateMod(const std::string& mod);
+    u32 activeSourceCount() const;
 
     /**
-     * Deactivates the currently active mod, restoring the moddable source to its vanilla state
+     * Draws which mod to use for each unlocked source at random (based upon their ratings), without moving anything yet
+     * 
+     * @param resource Where the plan's list of changes is allocated
      */
-    void deactivateMod();
+    RandomPlan planRandom(std::pmr::memory_resource* resource);
 
-    void deactivateAll();
+    /**
+     * Activates/deactivates mods to match the plan, only touching the sources whose pick changed
+     * 
+     * Progress is counted in sources, and checked for cancelling between them
+     * (so each source is always left either fully activated or fully deactivated)
+     */
+    void applyPlan(const RandomPlan& plan, Progress& progress);
 
     /**
-     * Randomly activates/deactivates all mods based upon their ratings
+     * Frees the index of Atmosphere's folder once a run of activations is done (the next activation builds it again)
      */
-    void randomize();
+    void releaseAtmosphereIndex();
 
     /**
-     * Randomly activates a mod from the current group and source
-     * 
-     * @requirement: group and source must be set
+     * Counts files & folders moved from now on in the progress (or stops counting with nullptr)
      */
-    void pickMod();
+    void setProgress(Progress* progress);
 
     /**
      * Unmount SD card when destroyed 
@@ -127,45 +147,165 @@ class Controller {
     ~Controller();
 
   private:
+    // Title-ID-specific paths, built once in init():
+    FsPath gamePath;
+    FsPath atmospherePath;
+
+    // What's in the game's Atmosphere folder, for checking conflicts:
+    AtmosphereIndex atmosphereIndex;
+
+    // The mod each folder moved into Atmosphere's folder as a whole belongs to, loaded in init():
+    FolderOwners folderOwners;
+
+    // Everything in the game's folder, loaded once in init() and kept up to date with every change made:
+    Catalog catalog;
+
+    // The game's saved profiles, loaded in init() along with the catalog:
+    ProfileList profiles;
+
+    // Whether to wait to save the active mods until a batch of changes is done:
+    bool holdActiveMods = false;
+
+    // Where to count moved files while a batch of changes is running on a worker:
+    Progress* progress = nullptr;
 
     /**
      * Returns all files belonging to a mod from the atmosphere active mods folder to their original location
      * 
      * Essentially the same as deactivating the mod, except this can't be used with the default mod option.
      */
-    void returnFiles(const std::string& mod);
+    void returnFiles(u32 mod);
+
+    /**
+     * Same as `returnFiles()`, except it pauses after each file/folder moved
+     */
+    Job returnFilesJob(u32 mod);
+
+    /**
+     * Returns everything in a list of moved files from the atmosphere folder to the mod's folder (pausing after each one), then deletes the list
+     * 
+     * Anything listed that's no longer in the atmosphere folder (such as when finishing an interrupted return) is skipped
+     * (anything else that can't be moved back is an error, and the list is kept so nothing is lost)
+     */
+    Job returnListed(const FsPath& movedFilesListPath, const FsPath& modPath);
+
+    /**
+     * Records that files are about to be moved for the mod, along with the list of moved files they're recorded in
+     */
+    void beginJournal(const FsPath& modPath, const FsPath& movedFilesListPath);
+
+    /**
+     * Clears the journal once the files recorded in it are all where they should be
+     */
+    void endJournal();
+
+    /**
+     * Finishes an activation/return that was interrupted (such as by a crash or the console turning off)
+     * 
+     * Either way, every file in its list is returned to the mod's folder, leaving the mod inactive
+     */
+    void recoverJournal();
+
+    /**
+     * Writes out the current block of the list of moved files,
+     * then moves each file/folder recorded in it from the mod's folder into Atmosphere's folder (pausing after each one)
+     */
+    Job moveRecorded(FsManager::ManifestWriter& movedFilesList, const FsPath& modPath);
+
+    /**
+     * Splits up a folder that another mod moved into Atmosphere's folder as a whole,
+     * recording everything in it under that mod's list of moved files individually instead
+     * 
+     * Needed before adding any other mod's files to the folder,
+     * otherwise they would be taken along when the other mod moves the folder back
+     * 
+     * If the owner's list of moved files can't be found, the folder's record is dropped instead
+     */
+    void releaseMovedFolder(const FsPath& folderPath);
+
+    /**
+     * Reads the catalog of the game's folder, building it from scratch if it's missing (or updating it if it's out of date)
+     */
+    void loadCatalog();
+
+    /**
+     * Writes out the active mods after they've changed (unless they're being held until a batch of changes is done)
+     */
+    void saveActiveMods();
+
+    /**
+     * Locks/unlocks a source in the current group
+     */
+    void setSourceLocked(u32 source, bool locked);
 
     /**
      * Gets Mod Alchemist's game directory:
      */
-    std::string getGamePath();
+    const FsPath& getGamePath();
 
     /**
      * Gets the file path for the specified group
      */
-    std::string getGroupPath();
+    FsPath getGroupPath();
 
     /**
      * Gets the file path for the specified source within the group
      */
-    std::string getSourcePath();
+    FsPath getSourcePath();
 
     /**
      * Get the file path for the specified mod within the moddable source
      */
-    std::string getModPath(const std::string& mod);
+    FsPath getModPath(u32 mod);
+
+    /**
+     * Gets the file path for the catalog of the game's folder
+     */
+    FsPath getCatalogPath();
+
+    /**
+     * Gets the file path for the ratings & locks changed in the overlay
+     */
+    FsPath getMetadataPath();
+
+    /**
+     * Gets the file path for the active mod of each source in the catalog
+     */
+    FsPath getActiveModsPath();
+
+    /**
+     * Gets the file path for the journal of the activation/return in progress
+     */
+    FsPath getJournalPath();
+
+    /**
+     * Gets the file path for the owners of folders moved into Atmosphere's folder as a whole
+     */
+    FsPath getFolderOwnersPath();
+
+    /**
+     * Gets the file path for the game's saved profiles
+     */
+    FsPath getProfilesPath();
 
     /**
      * Gets the game's path that's stored within Atmosphere's directory
      */
-    std::string getAtmospherePath();
+    const FsPath& getAtmospherePath();
 
     /**
      * Gets the file path for the list of moved files for the specified mod
      * 
      * The file should only exist if the mod is currently active
      */
-    std::string getMovedFilesListFilePath(const std::string& mod);
+    FsPath getMovedFilesListFilePath(u32 mod);
+
+    /**
+     * Gets the file path for the list of moved files for a mod within the specified source folder
+     * 
+     * @param legacy If the mod was activated by an older version, which used a txt list (see `Catalog::hasLegacyList()`)
+     */
+    FsPath getMovedFilesListFilePath(const FsPath& sourcePath, std::string_view mod, bool legacy);
 };
 
 extern Controller controller;
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * Heap usage of each screen & each long-running controller operation, for finding out what uses the most memory
+ * 
+ * Only built with `make DIAGNOSTICS=1` (which defines ALCHEMIST_DIAGNOSTICS).
+ * Otherwise the macros below are empty, and nothing here is compiled at all.
+ */
+#ifdef ALCHEMIST_DIAGNOSTICS
+
+#include <switch.h>
+
+#include "fs_path.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace Diagnostics {
+
+  // Most scopes that can be recorded, and most that can be running at once:
+  const u32 MAX_RECORDS = 32;
+  const u32 MAX_ACTIVE_SCOPES = 16;
+
+  /**
+   * Totals for everything that's run under one name
+   */
+  struct Record {
+    const char* name;
+    u32 runs;
+    u64 allocations;      // Allocations made while running
+    u64 allocatedBytes;   // Bytes allocated while running
+    s64 retainedBytes;    // Bytes still allocated when the last run ended (compared to when it started)
+    u64 peakLiveBytes;    // Most bytes allocated (by anything) at once while running
+    u64 peakHeapBytes;    // Most of the heap in use at the end of a run (according to malloc)
+  };
+
+  /**
+   * Records the allocations made from when it's created to when it's destroyed under the name
+   * 
+   * The name must be a string literal (it's kept, not copied).
+   */
+  class Scope {
+    public:
+      Scope(const char* name);
+      ~Scope();
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+    protected:
+      /**
+       * Allocations made since the scope started (not counting what was left out with `exclude()`)
+       */
+      u64 getAllocations() const;
+      u64 getAllocatedBytes() const;
+
+      /**
+       * Leaves allocations recorded by another scope (such as a screen opened from this one) out of this one's totals
+       */
+      void exclude(u64 allocations, u64 bytes);
+
+    private:
+      const char* name;
+      s32 slot; // Where the peak is tracked while running (-1 if there were too many running at once)
+      u64 startAllocations;
+      u64 startAllocatedBytes;
+      u64 startLiveBytes;
+  };
+
+  /**
+   * Records a screen from before it's created to after its elements are freed, as the screen's first base class
+   * (see DIAGNOSE_SCREEN), so its UI isn't counted as still allocated when it closes
+   * 
+   * What's allocated by screens opened from it is only recorded under those screens.
+   * Its peak still includes them, since it's the most allocated by anything at once.
+   */
+  class ScreenScope : public Scope {
+    public:
+      ScreenScope(const char* name);
+      ~ScreenScope();
+
+    private:
+      // The screen this one was opened from (nullptr for the first):
+      ScreenScope* parent;
+  };
+
+  /**
+   * A screen's name, kept as a template argument so DIAGNOSE_SCREEN can be used in the list of base classes
+   */
+  template <std::size_t Length>
+  struct ScreenName {
+    char text[Length];
+
+    constexpr ScreenName(const char (&name)[Length]) {
+      std::copy_n(name, Length, this->text);
+    }
+  };
+
+  template <ScreenName Name>
+  class NamedScreenScope : public ScreenScope {
+    public:
+      NamedScreenScope() : ScreenScope(Name.text) {}
+  };
+
+  /**
+   * Bytes currently allocated through new/delete, and the most there have ever been at once
+   */
+  u64 getLiveBytes();
+  u64 getPeakLiveBytes();
+
+  /**
+   * Bytes of the heap in use according to malloc (including what's allocated outside of new/delete)
+   */
+  u64 getHeapBytes();
+
+  /**
+   * Memory used by the whole overlay process, and how much it's allowed
+   */
+  u64 getProcessBytes();
+  u64 getProcessLimit();
+
+  u32 getRecordCount();
+  const Record& getRecord(u32 index);
+
+  /**
+   * Formats everything recorded as text, one line per record
+   */
+  std::string report();
+
+  /**
+   * Writes the report to a file
+   */
+  void dump(const FsPath& path);
+}
+
+// Records the rest of the current block under the name:
+#define DIAGNOSE(name) Diagnostics::Scope diagnosticsScope(name)
+
+// Records everything from when a screen is created to when it's closed.
+// Goes first in the screen's base classes, as in `class GuiMain : DIAGNOSE_SCREEN("GuiMain") public tsl::Gui`:
+#define DIAGNOSE_SCREEN(name) private Diagnostics::NamedScreenScope<name>,
+
+#else
+
+#define DIAGNOSE(name)
+#define DIAGNOSE_SCREEN(name)
+
+#endif // ALCHEMIST_DIAGNOSTICS
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <switch.h>
+
+#include "fs_path.h"
+
+#include <map>
+#include <string>
+#include <string_view>
+
+/**
+ * Which mod each folder that was moved into Atmosphere's folder as a whole belongs to, so other mods
+ * don't mix their files into it unnoticed (see FOLDER_OWNERS_NAME)
+ *
+ * Kept in the game's Mod Alchemist folder rather than in the moved folders themselves,
+ * so nothing but the mod's own files ends up in the game's Atmosphere folder.
+ * Folders are relative to the game's Atmosphere folder (starting with a '/'), and owners are recorded
+ * by group, source & mod name, so they still apply after the catalog is built again.
+ */
+class FolderOwners {
+  public:
+    struct Owner {
+      std::string group;
+      std::string source;
+      std::string mod;
+    };
+
+    /**
+     * Reads the owners from the file (leaving none if there's no file)
+     */
+    void load(const FsPath& path);
+
+    /**
+     * Writes out the owners if they've changed since they were last loaded or saved
+     */
+    void save(const FsPath& path);
+
+    /**
+     * Gets the owner of the folder (nullptr if the folder wasn't moved as a whole)
+     */
+    const Owner* find(std::string_view folder) const;
+
+    bool contains(std::string_view folder) const;
+
+    void add(std::string_view folder, std::string_view group, std::string_view source, std::string_view mod);
+    void remove(std::string_view folder);
+
+  private:
+    std::map<std::string, Owner, std::less<>> owners;
+    bool changed = false;
+};
@@ -3,8 +3,12 @@
 #include <switch.h>
 #include <switch/result.h>
 
+#include "constants.h"
+#include "fs_path.h"
+
 #include <vector>
 #include <string>
+#include <string_view>
 #include <memory>
 
 /**
@@ -14,21 +18,251 @@ namespace FsManager {
   extern FsFileSystem sdSystem;
 
   /**
-   * Creates a new open FsDir object for the specified path
+   * Reads the entries of a folder several at a time into a single reused buffer
+   * (each call to fsDirRead is an IPC round-trip, so reading 1 entry at a time is slow for large folders)
+   * 
+   * Only entries of the types requested in the mode are returned
+   */
+  class DirStream {
+    public:
+      DirStream(const FsPath& path, const u32& mode, const s64& batchSize = DIR_READ_BATCH_SIZE);
+      ~DirStream();
+
+      /**
+       * Gets the next entry in the folder
+       * 
+       * Returns nullptr once every entry has been read.
+       * The entry is only valid until the next call.
+       */
+      FsDirectoryEntry* next();
+
+    private:
+      FsDir dir;
+      u32 mode;
+      s64 batchSize;
+      std::unique_ptr<FsDirectoryEntry[]> entries;
+
+      // Number of entries in the buffer from the last read, and the position of the next one to return:
+      s64 readCount;
+      s64 readIndex;
+
+      bool finished;
+  };
+
+  /**
+   * Visits every entry in a folder tree exactly once (depth-first)
+   * 
+   * Only one folder is kept open for each level of depth, so memory doesn't grow with the number of entries.
+   * Folders are only walked into when `enter()` is called for them.
+   */
+  class TreeWalker {
+    public:
+      TreeWalker(const FsPath& root);
+
+      /**
+       * Moves on to the next entry in the tree
+       * 
+       * Returns nullptr once every entry has been visited.
+       * The entry is only valid until the next call.
+       */
+      FsDirectoryEntry* next();
+
+      /**
+       * Walks into the folder last returned by `next()`, so its entries are the next ones visited
+       */
+      void enter();
+
+      /**
+       * Full path of the entry last returned by `next()`
+       */
+      const FsPath& path() const;
+
+      /**
+       * Path of the entry last returned by `next()` relative to the root (starting with a '/')
+       */
+      std::string_view relativePath() const;
+
+    private:
+      FsPath currentPath;
+      std::size_t rootLength;
+
+      // The open folder for each level of depth that's currently being walked:
+      std::vector<std::unique_ptr<DirStream>> streams;
+
+      // Whether the last entry's name is at the end of currentPath (and needs removed before the next one):
+      bool hasEntry;
+  };
+
+  /**
+   * Appends text to the end of a file through a fixed-size block buffer,
+   * so the file is written & flushed once per block instead of once per line
+   * 
+   * Nothing is written until `flush()` is called (or the buffer fills up), not even when destroyed
+   */
+  class BlockWriter {
+    public:
+      BlockWriter(const FsPath& path, const s64& blockSize = WRITE_BLOCK_SIZE);
+      ~BlockWriter();
+
+      /**
+       * Checks if the specified number of bytes fits in what's left of the buffer
+       */
+      bool fits(const s64& size) const;
+
+      /**
+       * Adds the text to the buffer, writing out the buffer first if it's full
+       */
+      void append(std::string_view text);
+
+      /**
+       * Writes & flushes everything buffered to the file
+       * 
+       * Returns the text that was written, which stays valid until the next `append()`
+       */
+      std::string_view flush();
+
+      /**
+       * Checks if nothing has ever been written to the file
+       */
+      bool isEmpty() const;
+
+    private:
+      FsFile file;
+      s64 offset; // The end of the file
+      s64 blockSize;
+      std::unique_ptr<char[]> buffer;
+      s64 used; // How much of the buffer has been filled
+  };
+
+  /**
+   * Reads a file from start to end, keeping it open and reading it in large chunks
+   * (or all at once if it's smaller than the buffer)
+   */
+  class FileReader {
+    public:
+      FileReader(const FsPath& path, const s64& bufferSize = READ_BUFFER_SIZE);
+      ~FileReader();
+
+      /**
+       * Gets the next line (without its '\n')
+       * 
+       * Returns false once every line has been read.
+       * The line is only valid until the next call.
+       */
+      bool nextLine(std::string_view& line);
+
+      /**
+       * Gets up to the specified number of bytes from the current position without moving past them
+       * (fewer are returned only at the end of the file)
+       * 
+       * The bytes are only valid until the next call.
+       */
+      std::string_view peek(const s64& size);
+
+      /**
+       * Moves past bytes that were peeked
+       */
+      void skip(const s64& size);
+
+    private:
+      FsFile file;
+      s64 fileSize;
+      s64 offset; // Where in the file the next chunk is read from
+      std::unique_ptr<char[]> buffer;
+      s64 bufferSize;
+
+      // The part of the buffer that hasn't been handed out yet:
+      s64 start;
+      s64 end;
+
+      /**
+       * Moves the unread part of the buffer to the front, and fills the rest with the next chunk of the file
+       * 
+       * Returns false if there was nothing left to read
+       */
+      bool refill();
+  };
+
+  /**
+   * Appends the paths of moved files/folders to a list of moved files (see MANIFEST_EXT) in blocks,
+   * front-coding each path against the one before it
    * 
-   * Don't forget to close when done
+   * Lists in the legacy text format (one path per line) are appended to in that format instead
    */
-  FsDir openFolder(const std::string& path, const u32& mode);
+  class ManifestWriter {
+    public:
+      ManifestWriter(const FsPath& path);
+
+      /**
+       * Checks if a record for the path fits in what's left of the current block
+       */
+      bool fits(std::string_view path) const;
+
+      /**
+       * Records the path, writing out the current block first if it's full
+       */
+      void add(std::string_view path, bool isFolder);
+
+      /**
+       * Writes & flushes the current block to the file
+       * 
+       * Afterwards, `nextFlushed()` goes through the paths in the block that was written
+       */
+      void flush();
+
+      /**
+       * Gets the next path in the block written by the last `flush()`
+       * 
+       * Returns false once every path in it has been gone through.
+       * The path is only valid until the next call.
+       */
+      bool nextFlushed(std::string_view& path, bool& isFolder);
+
+    private:
+      bool legacy;
+      BlockWriter writer;
+
+      // The last path added (the next one is front-coded against it):
+      FsPath lastPath;
+
+      // The block written by the last flush, and the last path decoded from it:
+      std::string_view flushed;
+      FsPath flushedPath;
+  };
 
   /**
-   * Changes an FsDir instance to the specified path
+   * Reads the paths of moved files/folders from a list of moved files,
+   * in either the binary format or the legacy text format
    */
-  void changeFolder(FsDir& dir, const std::string& path, const u32& mode);
+  class ManifestReader {
+    public:
+      ManifestReader(const FsPath& path);
+
+      /**
+       * Gets the next path in the list
+       * 
+       * Returns false once every path has been read.
+       * The path is only valid until the next call.
+       */
+      bool next(std::string_view& path, bool& isFolder);
+
+    private:
+      FileReader reader;
+      bool legacy;
+      FsPath currentPath;
+  };
 
-  void createFolderIfNeeded(const std::string& path);
+  void createFolderIfNeeded(const FsPath& path);
 
-  bool doesFolderExist(const std::string& path);
-  bool doesFileExist(const std::string& path);
+  bool doesFolderExist(const FsPath& path);
+  bool doesFileExist(const FsPath& path);
+
+  /**
+   * Gets when a file or folder was last modified, for telling if it has changed
+   *
+   * Returns false if the time can't be read (such as if there's nothing at the path)
+   */
+  bool getModifiedTime(const FsPath& path, u64& time);
 
   /**
    * Gets a vector of all entity names that are directly within the specified path
@@ -37,17 +271,43 @@ namespace FsManager {
    * @param sort Whether to sort the list of names alphabetically or not
    *             Can take considerable performance when in nested loops, so sometimes it's good to skip if not needed
    */
-  std::vector<std::string> listNames(const std::string& path, bool sort);
+  std::vector<std::string> listNames(const FsPath& path, bool sort);
 
   /**
-   * Gets the folder name for an entity with the specified name
+   * Opens a file at the path (creating it if it doesn't exist)
    */
-  std::string getFolderName(const std::string& path, const std::string& name);
+  FsFile initFile(const FsPath& path);
 
   /**
-   * Opens a file at the path (creating it if it doesn't exist)
+   * Reads the entire contents of a (small) file
    */
-  FsFile initFile(const std::string& path);
+  std::string readFile(const FsPath& path);
+
+  /**
+   * Replaces the contents of the file at the path with the text (creating the file if it doesn't exist)
+   */
+  void writeFile(const FsPath& path, std::string_view text);
+
+  /**
+   * Replaces the contents of the file at the path with the text, so the file has either all of its old contents or all of its new ones
+   * 
+   * The text is written to a temporary file first (see REPLACEMENT_EXT), which then takes the file's place.
+   */
+  void replaceFile(const FsPath& path, std::string_view text);
+
+  /**
+   * Finishes a `replaceFile()` that was interrupted after the old file was deleted
+   * 
+   * Call before reading a file that's written with `replaceFile()`
+   */
+  void finishReplacingFile(const FsPath& path);
+
+  void deleteFile(const FsPath& path);
+
+  /**
+   * Deletes the file if there is one at the path
+   */
+  void deleteFileIfExists(const FsPath& path);
 
   /**
    * Records the text parameter in the filePath, appending it to the FsFile
@@ -55,17 +315,24 @@ namespace FsManager {
    * offset is expected to be at the end of the file,
    * and it's updated to the new position at the end of file
    */
-  void write(FsFile& file, const std::string& text, s64& offset);
+  void write(FsFile& file, std::string_view text, s64& offset);
 
   /**
    * Changes the fromPath file parameter's location to what's specified as the toPath parameter
    */
-  void moveFile(const std::string& fromPath, const std::string& toPath);
+  void moveFile(const FsPath& fromPath, const FsPath& toPath);
+
+  /**
+   * Changes the fromPath folder's location (along with everything in it) to what's specified as the toPath parameter
+   */
+  void moveFolder(const FsPath& fromPath, const FsPath& toPath);
 
   /**
-   * Formats a string as a char array that will work properly as a parameter for libnx's filesystem functions
+   * Same as `moveFile()`/`moveFolder()`, except nothing happens if there's nothing at the fromPath
    * 
-   * Use `get()` when passing it to a libnx function
+   * Returns whether anything was moved.
+   * Anything else that stops the move (such as the toPath's folder being missing) is still an error.
    */
-  std::unique_ptr<char[]> toPathBuffer(const std::string& path);
+  bool moveFileIfExists(const FsPath& fromPath, const FsPath& toPath);
+  bool moveFolderIfExists(const FsPath& fromPath, const FsPath& toPath);
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <switch.h>
+
+#include <string>
+#include <string_view>
+
+/**
+ * A file path stored in a fixed-size buffer instead of on the heap
+ *
+ * Can be passed directly to libnx's filesystem functions with `c_str()`
+ */
+class FsPath {
+  public:
+    FsPath();
+    FsPath(const char* path);
+    FsPath(std::string_view path);
+    FsPath(const std::string& path);
+
+    /**
+     * Adds the text to the end of the path as-is
+     */
+    FsPath& append(std::string_view text);
+
+    /**
+     * Adds a '/' followed by the segment to the end of the path
+     */
+    FsPath& join(std::string_view segment);
+
+    /**
+     * Removes the last segment (and the '/' before it) from the end of the path
+     */
+    void popSegment();
+
+    /**
+     * Shortens the path to the specified length
+     */
+    void truncate(std::size_t length);
+
+    std::size_t length() const;
+    bool empty() const;
+
+    const char* c_str() const;
+    std::string_view view() const;
+
+  private:
+    char buffer[FS_MAX_PATH];
+    u16 size;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <switch.h>
+
+#include <coroutine>
+
+/**
+ * Work that can be paused part-way through (a C++20 coroutine), so it can be spread out over several frames
+ * 
+ * A function becomes a job by returning Job, and it pauses with `co_await Job::pause()` wherever it's safe to stop for a while.
+ * Another job can be run inside of it with `co_await`, which pauses wherever that job pauses.
+ * Nothing runs until the job is stepped (or run to the end).
+ */
+class Job {
+  public:
+    struct promise_type {
+      // The job being awaited, which is stepped instead until it's done:
+      std::coroutine_handle<promise_type> child;
+
+      Job get_return_object();
+      std::suspend_always initial_suspend() noexcept;
+      std::suspend_always final_suspend() noexcept;
+      void return_void();
+      void unhandled_exception();
+    };
+
+    struct Awaiter;
+
+    /**
+     * A job with nothing to do
+     */
+    Job();
+
+    Job(Job&& other);
+    Job& operator=(Job&& other);
+    ~Job();
+
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+
+    /**
+     * Pauses a job until it's stepped again
+     */
+    static std::suspend_always pause();
+
+    Awaiter operator co_await() &&;
+
+    /**
+     * Runs the job until it next pauses
+     * 
+     * Returns false once it's done
+     */
+    bool step();
+
+    /**
+     * Runs the job until it's done or it pauses after the time is up (it always takes at least one step)
+     * 
+     * Returns false once it's done
+     */
+    bool runFor(u64 nanoseconds);
+
+    /**
+     * Runs the job until it's done
+     */
+    void run();
+
+    bool isDone() const;
+
+  private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Job(std::coroutine_handle<promise_type> handle);
+};
+
+/**
+ * Runs a job inside of another one (see `co_await`)
+ */
+struct Job::Awaiter {
+  Job job;
+
+  bool await_ready() const;
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> parent);
+  void await_resume();
+};
@@ -3,36 +3,28 @@
 #include <switch.h>
 
 #include <string>
+#include <string_view>
 
 namespace MetaManager {
-  
-  /**
-   * Formats a u64 title ID into a hexidecimal string
-   */
-  std::string getHexTitleId(const u64& titleId);
-
-  /**
-   * Parses the name of an entity from a folder name
-   */
-  std::string parseName(const std::string& folderName);
 
   /**
-   * Parses a rating of a mod from a folder name
+   * What a folder name says about the entity it belongs to
+   * 
+   * The name is part of the folder name that was parsed, so it's only valid as long as that is
    */
-  u8 parseRating(const std::string& folderName);
-
-  /**
-   * Parses whether a source is locked from randomization or not from the source's folder name
-   */
-  bool parseLockedStatus(const std::string& folderName);
-
+  struct FolderName {
+    std::string_view name;
+    u8 rating;
+    bool locked;
+  };
+  
   /**
-   * Builds a folder name from a mod name and rating
+   * Formats a u64 title ID into a hexidecimal string
    */
-  std::string buildFolderName(const std::string& modName, const u8& rating, bool locked);
+  std::string getHexTitleId(const u64& titleId);
 
   /**
-   * Checks if the entity name belongs to a folder name
+   * Parses the name, rating & locked status of an entity from a folder name in one pass, without copying anything
    */
-  bool namesMatch(char* folderName, const std::string& entityName);
-}
\ No newline at end of file
+  FolderName parseFolderName(std::string_view folderName);
+}
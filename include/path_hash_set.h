@@ -0,0 +1,77 @@
+#pragma once
+
+#include <switch.h>
+
+#include <memory>
+#include <string_view>
+
+/**
+ * Set of 64-bit hashes of paths, using a fixed amount of memory no matter how long the paths are
+ * 
+ * Uses open addressing (linear probing) with a Bloom filter in front of it,
+ * so most lookups for paths that aren't in the set only check a single word of the filter.
+ * 
+ * Different paths can (very rarely) have the same hash, so whatever uses it decides whether a hit is worth checking.
+ */
+class PathHashSet {
+  public:
+    /**
+     * @param memoryBudget Bytes to use for the table & filter (allocated up front)
+     */
+    PathHashSet(std::size_t memoryBudget);
+
+    /**
+     * Hashes text (FNV-1a). Pass a previous hash as the seed to hash text that continues on from it.
+     */
+    static u64 hash(std::string_view text, u64 seed = 0xCBF29CE484222325);
+
+    /**
+     * Adds the hash to the set
+     * 
+     * Returns false if the set was too full to add it
+     */
+    bool insert(u64 hash);
+
+    void erase(u64 hash);
+
+    bool contains(u64 hash) const;
+
+    void clear();
+
+    std::size_t size() const;
+
+    /**
+     * Maximum number of hashes the set holds before `insert()` starts failing
+     */
+    std::size_t maxSize() const;
+
+  private:
+    // Values of slots that don't hold a hash (hashes with these values are changed to something else):
+    static const u64 EMPTY_SLOT = 0;
+    static const u64 ERASED_SLOT = 1;
+
+    std::unique_ptr<u64[]> slots;
+    std::size_t slotMask; // Number of slots - 1 (always a power of 2)
+
+    std::unique_ptr<u64[]> filter;
+    std::size_t filterMask; // Number of bits in the filter - 1 (always a power of 2)
+
+    std::size_t count;
+    std::size_t erasedCount;
+
+    static u64 toSlotValue(u64 hash);
+
+    /**
+     * Finds the slot holding the value, or the slot it should go in if it's not in the set
+     */
+    std::size_t findSlot(u64 value) const;
+
+    bool mayContain(u64 value) const;
+
+    void addToFilter(u64 value);
+
+    /**
+     * Re-inserts everything in place to clear out erased slots (without a second copy of the table)
+     */
+    void rehash();
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <switch.h>
+
+#include "catalog.h"
+#include "fs_path.h"
+#include "random_plan.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Named sets of which mod is active for each source, saved for each game (see PROFILES_NAME)
+ *
+ * Groups, sources & mods are recorded by name rather than by ID,
+ * so a profile still applies after the catalog is built again (or a rating changes a folder's name).
+ */
+class ProfileList {
+  public:
+    /**
+     * Reads the profiles from the file (leaving none if there's no file)
+     */
+    void load(const FsPath& path);
+
+    void save(const FsPath& path) const;
+
+    u32 count() const;
+
+    std::string_view name(u32 profile) const;
+
+    /**
+     * Adds a profile with the mods that are active now, named after the first number that isn't taken
+     */
+    void add(const Catalog& catalog);
+
+    /**
+     * Replaces the profile's mods with the ones that are active now
+     */
+    void update(u32 profile, const Catalog& catalog);
+
+    void remove(u32 profile);
+
+    /**
+     * Fills the plan with the changes needed for the profile's mods to be active
+     *
+     * Sources that already match the profile are left out (see `RandomPlan::add()`), as are
+     * sources the profile doesn't have and mods that can no longer be found.
+     */
+    void plan(u32 profile, const Catalog& catalog, RandomPlan& plan) const;
+
+  private:
+    struct Pick {
+      std::string group;
+      std::string source;
+      std::string mod; // Empty for using no mod
+    };
+
+    struct Profile {
+      std::string name;
+      std::vector<Pick> picks;
+    };
+
+    std::vector<Profile> profiles;
+
+    /**
+     * Records the mod that's active now for every source
+     */
+    static void recordActiveMods(const Catalog& catalog, std::vector<Pick>& picks);
+};
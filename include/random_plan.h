@@ -0,0 +1,87 @@
+#pragma once
+
+#include <switch.h>
+
+#include "catalog.h"
+
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+/**
+ * Picks one of several options at random in constant time, weighted by their ratings (the alias method)
+ */
+class AliasTable {
+  public:
+    /**
+     * Builds the table for the weights
+     * 
+     * Returns false if every weight is 0 (in which case nothing can be picked)
+     */
+    bool build(const std::vector<u32>& weights);
+
+    /**
+     * Gets the index of a weight, picked at random
+     */
+    u32 pick(std::mt19937_64& random) const;
+
+  private:
+    // Each option gets an equal-sized slot, which is split between the option itself & one other option (its alias):
+    std::vector<u64> thresholds; // Out of `total`, how much of the slot picks the option itself
+    std::vector<u32> aliases;
+    u64 total;
+
+    // Options with less/more than a full slot while building (kept so building again doesn't allocate):
+    std::vector<u32> small;
+    std::vector<u32> large;
+};
+
+/**
+ * The mod picked at random for every unlocked source, drawn before anything is moved
+ * 
+ * Only sources whose pick is different from their active mod are kept,
+ * so what's going to change can be shown before any files are moved.
+ * 
+ * Profiles are applied through a plan as well (see `ProfileList::plan()`), with their picks added one at a time.
+ */
+class RandomPlan {
+  public:
+    struct Change {
+      u32 group;
+      u32 source;
+      u32 mod; // Catalog::NONE to leave the source without a mod
+    };
+
+    /**
+     * @param resource Where the list of changes is allocated
+     */
+    RandomPlan(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Draws a mod for every unlocked source in the catalog, based upon the ratings
+     */
+    void draw(const Catalog& catalog);
+
+    /**
+     * Adds a change to the plan, unless the mod is already the source's active mod
+     */
+    void add(const Catalog& catalog, u32 group, u32 source, u32 mod);
+
+    /**
+     * Empties the plan
+     */
+    void clear();
+
+    const std::pmr::vector<Change>& changes() const;
+
+    /**
+     * Number of files that are going to be moved, either into Atmosphere's folder or back to their mod's folder
+     * 
+     * Mods that are already active count what's in their list of moved files (see `Catalog::modFileCount()`)
+     */
+    u64 fileCount() const;
+
+  private:
+    std::pmr::vector<Change> changeList;
+    u64 files = 0;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <switch.h>
+
+#include "constants.h"
+
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * Memory for a screen's own containers, which is all released at once when the screen is closed
+ * 
+ * Nothing is freed until then, so a screen's allocations don't leave gaps scattered through the heap.
+ * The first SCREEN_ARENA_SIZE bytes are part of the screen itself; more is only taken from the heap if it runs out.
+ * 
+ * Declare it before the containers that use it, so it outlives them.
+ */
+class ScreenArena {
+  public:
+    ScreenArena();
+
+    ScreenArena(const ScreenArena&) = delete;
+    ScreenArena& operator=(const ScreenArena&) = delete;
+
+    std::pmr::memory_resource* get();
+
+  private:
+    alignas(std::max_align_t) std::byte initial[SCREEN_ARENA_SIZE];
+    std::pmr::monotonic_buffer_resource resource;
+};
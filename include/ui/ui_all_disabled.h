@@ -3,16 +3,24 @@
 
 #include <tesla.hpp>    // The Tesla Header
 
-class GuiAllDisabled : public tsl::Gui {
+#include "diagnostics.h"
+#include "ui/worker_status.h"
+
+class GuiAllDisabled : DIAGNOSE_SCREEN("GuiAllDisabled") public tsl::Gui {
   private:
     tsl::elm::List* items;
     tsl::elm::ListItem* yes;
 
+    // Moves the files in the background, so the menu keeps drawing progress while it works:
+    WorkerStatus status { this, "mod", "All mods have been disabled.", "disabled" };
+
   public:
     GuiAllDisabled();
 
     virtual tsl::elm::Element* createUI() override;
 
+    virtual void update() override;
+
     virtual bool handleInput(
       u64 keysDown,
       u64 keysHeld,
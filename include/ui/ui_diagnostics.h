@@ -0,0 +1,32 @@
+#ifndef GUI_DIAGNOSTICS_HPP
+#define GUI_DIAGNOSTICS_HPP
+
+#include "diagnostics.h"
+
+#ifdef ALCHEMIST_DIAGNOSTICS
+
+#include <tesla.hpp>    // The Tesla Header
+
+/**
+ * Hidden screen showing heap usage for each screen & operation (see Diagnostics)
+ * 
+ * Opened by holding ZL and pressing ZR on the main menu, in builds made with `make DIAGNOSTICS=1`
+ */
+class GuiDiagnostics : public tsl::Gui {
+  public:
+    GuiDiagnostics();
+
+    virtual tsl::elm::Element* createUI() override;
+
+    virtual bool handleInput(
+      u64 keysDown,
+      u64 keysHeld,
+      const HidTouchState &touchPos,
+      HidAnalogStickState joyStickPosLeft,
+      HidAnalogStickState joyStickPosRight
+    ) override;
+};
+
+#endif // ALCHEMIST_DIAGNOSTICS
+
+#endif // GUI_DIAGNOSTICS_HPP
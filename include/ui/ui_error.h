@@ -5,7 +5,9 @@
 
 #include <tesla.hpp>    // The Tesla Header
 
-class GuiError : public tsl::Gui {
+#include "diagnostics.h"
+
+class GuiError : DIAGNOSE_SCREEN("GuiError") public tsl::Gui {
   private:
     std::string message;
 
@@ -28,6 +30,14 @@ class GuiError : public tsl::Gui {
      * @param alchemyCode: Code to indicate the origin of the error in Mod Alchemist's code
      */
     static void tryResult(const Result& r, const std::string& alchemyCode);
+
+    /**
+     * Displays the error to the user and stops
+     *
+     * On a worker's thread, only the task is stopped, and its screen displays the error instead (see WorkerStatus),
+     * since only the UI thread may change screens.
+     */
+    [[noreturn]] static void fail(const std::string& message);
 };
 
 #endif // GUI_ERROR_HPP
@@ -8,7 +8,9 @@
 
 #include <tesla.hpp>    // The Tesla Header
 
-class GuiGroups : public tsl::Gui {
+#include "diagnostics.h"
+
+class GuiGroups : DIAGNOSE_SCREEN("GuiGroups") public tsl::Gui {
   public:
     GuiGroups();
 
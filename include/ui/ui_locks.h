@@ -3,7 +3,19 @@
 
 #include <tesla.hpp>
 
-class GuiLocks : public tsl::Gui {
+#include "diagnostics.h"
+#include "ui/virtual_list.h"
+
+#include <string>
+
+class GuiLocks : DIAGNOSE_SCREEN("GuiLocks") public tsl::Gui {
+  private:
+    // A row for each of the group's sources:
+    VirtualList* list;
+
+    // Reused for each row's text as it's scrolled to:
+    std::string label;
+
   public:
     GuiLocks();
 
@@ -3,10 +3,20 @@
 
 #include <tesla.hpp>    // The Tesla Header
 
-class GuiMain : public tsl::Gui {
+#include "diagnostics.h"
+
+class GuiMain : DIAGNOSE_SCREEN("GuiMain") public tsl::Gui {
   public:
     GuiMain();
     virtual tsl::elm::Element* createUI() override;
+
+    virtual bool handleInput(
+      u64 keysDown,
+      u64 keysHeld,
+      const HidTouchState &touchPos,
+      HidAnalogStickState joyStickPosLeft,
+      HidAnalogStickState joyStickPosRight
+    ) override;
 };
 
 #endif // GUI_MAIN_HPP
\ No newline at end of file
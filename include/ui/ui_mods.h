@@ -3,23 +3,75 @@
 
 #include <tesla.hpp>    // The Tesla Header
 
-#include <vector>
+#include "diagnostics.h"
+#include "job.h"
+#include "worker.h"
+#include "ui/virtual_list.h"
 
-class GuiMods : public tsl::Gui {
+#include <string>
+
+class GuiMods : DIAGNOSE_SCREEN("GuiMods") public tsl::Gui {
   private:
-    std::vector<tsl::elm::ToggleListItem*> toggles;
+    std::string sourceName;
+
+    // Row 0 is the default option, followed by a row for each mod:
+    VirtualList* list;
+
+    // The mod being turned on/off, moved a little each frame (see update()):
+    Job job;
+    Progress progress;
+    bool switching = false;
+    u32 jobRow;
+    u32 jobMod;
+    u32 jobFileCount = 0;
+
+    /**
+     * Gets the mod shown in a row (Catalog::NONE for the default option)
+     */
+    u32 modOf(u32 row) const;
+
+    /**
+     * Fills in a toggle with a row's mod & whether it's active
+     */
+    void bindToggle(tsl::elm::ToggleListItem* toggle, u32 row);
 
-    void activateMod(const std::string& mod, tsl::elm::ToggleListItem* toggle);
-    void deactivateMod(const std::string& mod);
+    /**
+     * Handles a row's toggle being turned on/off
+     * 
+     * Turning on a mod activates it (deactivating the current active one), turning one off activates the default option,
+     * and the default option can't be turned off unless another mod is being activated
+     */
+    void toggle(u32 row, bool state);
 
-    void activateDefaultMod();
-    void deactivateDefaultMod();
+    /**
+     * Starts switching the source to the mod (or to no mod with Catalog::NONE)
+     */
+    void startSwitch(u32 row, u32 mod);
+
+    /**
+     * Deactivates the active mod, then activates the new one
+     */
+    Job switchMod(u32 mod);
+
+    /**
+     * Updates the toggles once the job is done
+     */
+    void finishSwitch();
+
+    std::string progressText() const;
 
   public:
     GuiMods();
 
+    /**
+     * Finishes moving files if the menu is closed part-way through
+     */
+    ~GuiMods();
+
     virtual tsl::elm::Element* createUI() override;
 
+    virtual void update() override;
+
     virtual bool handleInput(
       u64 keysDown,
       u64 keysHeld,
@@ -0,0 +1,61 @@
+#ifndef GUI_PROFILES_HPP
+#define GUI_PROFILES_HPP
+
+#include <tesla.hpp>    // The Tesla Header
+
+#include "diagnostics.h"
+#include "random_plan.h"
+#include "screen_arena.h"
+#include "ui/worker_status.h"
+
+/**
+ * UI for saving which mods are active as a profile, and applying saved profiles
+ */
+class GuiProfiles : DIAGNOSE_SCREEN("GuiProfiles") public tsl::Gui {
+  private:
+    ScreenArena arena;
+
+    tsl::elm::List* items;
+
+    // Only what differs from a profile (reused for each one):
+    RandomPlan plan { this->arena.get() };
+
+    // How many sources each profile would change, planned once when the menu is opened
+    // (adding, overwriting or deleting a profile leaves the active mods as they are, so the other counts stay the same):
+    std::pmr::vector<u32> changeCounts { this->arena.get() };
+
+    // Moves the files in the background, so the menu keeps drawing progress while it works:
+    WorkerStatus status { this, "item", "Finished!", "changed" };
+
+    /**
+     * Plans each profile to count how many sources it would change
+     */
+    void countChanges();
+
+    /**
+     * Fills the menu with an option for each profile (along with how many sources it would change)
+     */
+    void showProfiles();
+
+    /**
+     * Starts changing the mods that differ from the profile
+     */
+    void apply(u32 profile);
+
+  public:
+    GuiProfiles();
+
+    virtual tsl::elm::Element* createUI() override;
+
+    virtual void update() override;
+
+    virtual bool handleInput(
+      u64 keysDown,
+      u64 keysHeld,
+      const HidTouchState &touchPos,
+      HidAnalogStickState joyStickPosLeft,
+      HidAnalogStickState joyStickPosRight
+    ) override;
+};
+
+#endif // GUI_PROFILES_HPP
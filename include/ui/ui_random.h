@@ -3,19 +3,34 @@
 
 #include <tesla.hpp>    // The Tesla Header
 
+#include "diagnostics.h"
+#include "random_plan.h"
+#include "screen_arena.h"
+#include "ui/worker_status.h"
+
 /**
  * UI for activating / deactivating mods at random
  */
-class GuiRandom : public tsl::Gui {
+class GuiRandom : DIAGNOSE_SCREEN("GuiRandom") public tsl::Gui {
   private:
+    ScreenArena arena;
+
     tsl::elm::List* items;
     tsl::elm::ListItem* yes;
-    
+
+    // Drawn when the menu is opened, so what's going to change can be shown first:
+    RandomPlan plan;
+
+    // Moves the files in the background, so the menu keeps drawing progress while it works:
+    WorkerStatus status { this, "item", "Finished!", "changed" };
+
   public:
     GuiRandom();
 
     virtual tsl::elm::Element* createUI() override;
 
+    virtual void update() override;
+
     virtual bool handleInput(
       u64 keysDown,
       u64 keysHeld,
@@ -25,4 +40,4 @@ class GuiRandom : public tsl::Gui {
     ) override;
 };
 
-#endif // GUI_RANDOM_HPP
\ No newline at end of file
+#endif // GUI_RANDOM_HPP
@@ -3,14 +3,28 @@
 
 #include <tesla.hpp>    // The Tesla Header
 
+#include "diagnostics.h"
+#include "screen_arena.h"
+#include "ui/virtual_list.h"
+
 #include <string>
 #include <map>
+#include <memory_resource>
 
-class GuiRatings : public tsl::Gui {
+class GuiRatings : DIAGNOSE_SCREEN("GuiRatings") public tsl::Gui {
   private:
-    u8 savedDefaultRating;
+    ScreenArena arena;
+
     u8 defaultRating;
-    std::map<std::string, u8> changedRatings;
+    std::pmr::map<u32, u8> changedRatings { this->arena.get() }; // By mod ID
+
+    // Row 0 is the default option, followed by a row for each mod:
+    VirtualList* list;
+
+    /**
+     * Gets the mod shown in a row (Catalog::NONE for the default option)
+     */
+    u32 modOf(u32 row) const;
 
   public:
     GuiRatings();
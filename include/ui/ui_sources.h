@@ -5,7 +5,9 @@
 
 #include <tesla.hpp>
 
-class GuiSources : public tsl::Gui {
+#include "diagnostics.h"
+
+class GuiSources : DIAGNOSE_SCREEN("GuiSources") public tsl::Gui {
   public:
     GuiSources();
 
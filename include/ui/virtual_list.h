@@ -0,0 +1,114 @@
+#ifndef UI_VIRTUAL_LIST_HPP
+#define UI_VIRTUAL_LIST_HPP
+
+#include <tesla.hpp>    // The Tesla Header
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * A list that only has elements for the rows that fit on screen, reusing them for other rows as it scrolls
+ * 
+ * Every row is the same kind of element, which is filled in from the screen's data (such as the catalog) whenever
+ * it comes into view. So memory stays the same no matter how many rows there are.
+ * 
+ * The list is focused as a whole, and passes input on to the element of the selected row.
+ */
+class VirtualList : public tsl::elm::Element {
+  public:
+    // Creates an element for showing rows (only called for as many as fit on screen):
+    typedef std::function<tsl::elm::Element*()> RowFactory;
+
+    // Fills in an element with a row's contents:
+    typedef std::function<void(tsl::elm::Element* element, u32 row)> RowBinder;
+
+    // Gets the text of the header above a row:
+    typedef std::function<std::string(u32 row)> RowLabel;
+
+    /**
+     * @param labelRow Leave empty for rows without a header above them
+     */
+    VirtualList(u32 rowCount, RowFactory createRow, RowBinder bindRow, RowLabel labelRow = nullptr);
+    virtual ~VirtualList();
+
+    /**
+     * Adds an element above the rows (such as a header), which scrolls along with them
+     */
+    void addHeader(tsl::elm::Element* element);
+
+    /**
+     * Gets the row an element is currently showing
+     */
+    u32 rowOf(tsl::elm::Element* element) const;
+
+    /**
+     * Gets the element showing a row (nullptr if it isn't on screen)
+     */
+    tsl::elm::Element* elementFor(u32 row) const;
+
+    /**
+     * Fills in every row on screen again (after the data behind them changes)
+     */
+    void refresh();
+
+    virtual void draw(tsl::gfx::Renderer* renderer) override;
+    virtual void layout(u16 parentX, u16 parentY, u16 parentWidth, u16 parentHeight) override;
+
+    virtual tsl::elm::Element* requestFocus(tsl::elm::Element* oldFocus, tsl::FocusDirection direction) override;
+    virtual void setFocused(bool focused) override;
+    virtual void drawHighlight(tsl::gfx::Renderer* renderer) override;
+
+    virtual bool onClick(u64 keys) override;
+    virtual bool handleInput(
+      u64 keysDown,
+      u64 keysHeld,
+      const HidTouchState &touchPos,
+      HidAnalogStickState joyStickPosLeft,
+      HidAnalogStickState joyStickPosRight
+    ) override;
+
+  private:
+    u32 rowCount;
+    RowFactory createRow;
+    RowBinder bindRow;
+    RowLabel labelRow;
+
+    std::vector<tsl::elm::Element*> headers;
+    s32 headersHeight = 0;
+
+    // Elements for showing rows (row `r` is always shown by slot `r % slots.size()`):
+    std::vector<tsl::elm::Element*> slots;
+    std::vector<tsl::elm::CategoryHeader*> slotLabels;
+    std::vector<u32> slotRows; // The row each slot was last filled in with
+    s32 labelHeight = 0;
+    s32 rowHeight = 0;
+
+    // The rows on screen (from the first up to, but not including, the end):
+    u32 firstRow = 0;
+    u32 endRow = 0;
+
+    u32 cursor = 0; // The selected row
+    s32 scroll = 0; // Pixels scrolled past the top of the list
+    bool focused = false;
+    u32 heldFrames = 0; // For repeating while up/down is held
+
+    /**
+     * Creates as many slots as it takes to fill the list's height
+     */
+    void createSlots();
+
+    /**
+     * Scrolls so the selected row is on screen, then moves each slot to where its row is (filling it in if it changed)
+     */
+    void placeRows();
+
+    /**
+     * Selects another row, moving the focus to its element
+     */
+    void moveCursor(u32 row);
+
+    tsl::elm::Element* cursorElement() const;
+};
+
+#endif // UI_VIRTUAL_LIST_HPP
@@ -0,0 +1,59 @@
+#ifndef UI_WORKER_STATUS_HPP
+#define UI_WORKER_STATUS_HPP
+
+#include <tesla.hpp>    // The Tesla Header
+
+#include "worker.h"
+
+#include <string>
+
+/**
+ * Runs a screen's task on a worker, replacing the screen's list with how far along it is
+ * ("Working..." until it's done, then whether it finished or was stopped)
+ *
+ * The screen passes its `update()` on, which is also where an error in the task is shown (see `GuiError::fail()`).
+ */
+class WorkerStatus {
+  public:
+    /**
+     * @param itemName What the task changes one at a time (such as "mod")
+     * @param finishedText Shown once the task has done everything
+     * @param changedText What happened to the items that were done before the task was stopped (such as "disabled")
+     */
+    WorkerStatus(tsl::Gui* gui, std::string itemName, std::string finishedText, std::string changedText);
+
+    /**
+     * Starts the task, replacing everything in the list with its status
+     */
+    void start(tsl::elm::List* items, Worker::Task task);
+
+    /**
+     * Shows how far along the task is, then what was done once it's finished
+     */
+    void update();
+
+    /**
+     * Asks the task to stop after the current item if it's running
+     *
+     * Returns false if it isn't running
+     */
+    bool stop();
+
+  private:
+    tsl::Gui* gui;
+    std::string itemName;
+    std::string finishedText;
+    std::string changedText;
+
+    // Moves the files in the background, so the menu keeps drawing progress while it works:
+    Worker worker;
+    tsl::elm::List* items = nullptr;
+    tsl::elm::ListItem* status = nullptr;
+
+    /**
+     * Replaces the list with what was done once the worker is finished
+     */
+    void showFinished();
+};
+
+#endif // UI_WORKER_STATUS_HPP
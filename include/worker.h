@@ -0,0 +1,80 @@
+#pragma once
+
+#include <switch.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+
+/**
+ * How far along a task is, updated by the task & read by the menu while it runs
+ */
+struct Progress {
+  std::atomic<u32> done = 0;
+  std::atomic<u32> total = 0;
+  std::atomic<u64> files = 0; // Files & folders moved so far
+
+  // Set by the menu; the task stops at the next point where nothing is left half-done:
+  std::atomic<bool> cancelled = false;
+
+  // Set if the task was stopped by an error, which the menu shows (error is written before failed is set):
+  std::atomic<bool> failed = false;
+  std::string error;
+};
+
+/**
+ * Runs a task on its own thread, so the overlay keeps drawing (and taking input) while files are moved
+ * 
+ * Only one task runs at a time, and nothing else should use the controller until it's finished.
+ */
+class Worker {
+  public:
+    typedef std::function<void(Progress&)> Task;
+
+    /**
+     * Waits for the task to finish if it's still running
+     */
+    ~Worker();
+
+    void start(Task task);
+
+    bool isRunning() const;
+
+    /**
+     * Checks if a task was started and has finished (whether or not it was cancelled)
+     */
+    bool isFinished() const;
+
+    /**
+     * Asks the task to stop as soon as it safely can
+     */
+    void cancel();
+
+    const Progress& getProgress() const;
+
+    /**
+     * Checks if this is a worker's thread (which must never touch the menu)
+     */
+    static bool isWorkerThread();
+
+    /**
+     * Stops the task running on this thread because of an error, leaving the message in its progress for the menu to show
+     *
+     * Nothing is unwound: like an error on the UI thread, it's followed by stopping Mod Alchemist, and the journal
+     * finishes whatever was left half-done the next time it's opened.
+     */
+    [[noreturn]] static void fail(const std::string& message);
+
+  private:
+    Thread thread;
+    Task task;
+    Progress progress;
+
+    bool started = false;
+    std::atomic<bool> finished = false;
+
+    // The worker whose task is running on this thread (nullptr on the UI thread):
+    static thread_local Worker* current;
+
+    static void run(void* worker);
+};
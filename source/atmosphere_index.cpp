@@ -0,0 +1,88 @@
+#include "atmosphere_index.h"
+
+#include "constants.h"
+#include "fs_manager.h"
+
+AtmosphereIndex::AtmosphereIndex() : built(false), complete(true) {}
+
+/**
+ * Walks through the Atmosphere folder, indexing everything in it
+ */
+void AtmosphereIndex::build(const FsPath& atmospherePath, const FolderOwners& owners) {
+  if (this->paths) {
+    this->paths->clear();
+  } else {
+    this->paths = std::make_unique<PathHashSet>(ATMOSPHERE_INDEX_MEMORY);
+  }
+  this->built = true;
+  this->complete = true;
+  this->atmospherePath = atmospherePath;
+
+  FsManager::TreeWalker walker(atmospherePath);
+
+  while (this->complete) {
+    FsDirectoryEntry* entry = walker.next();
+    if (!entry) { break; }
+
+    bool isFolder = entry->type == FsDirEntryType_Dir;
+    this->add(walker.relativePath(), isFolder);
+
+    // Nothing is added to folders moved as a whole by a mod until they're split up, so their contents aren't needed:
+    if (isFolder && !owners.contains(walker.relativePath())) {
+      walker.enter();
+    }
+  }
+}
+
+/**
+ * Forgets everything indexed, freeing its memory (the next `build()` starts from scratch)
+ */
+void AtmosphereIndex::clear() {
+  this->paths.reset();
+  this->built = false;
+  this->complete = true;
+}
+
+bool AtmosphereIndex::isBuilt() const {
+  return this->built;
+}
+
+bool AtmosphereIndex::contains(std::string_view path, bool isFolder) const {
+  if (this->built && this->complete) {
+    return this->paths->contains(toKey(path, isFolder));
+  }
+
+  // Without everything in the index, a path that isn't in it could still be there:
+  return this->exists(path, isFolder);
+}
+
+/**
+ * Keep the index up to date as files & folders are moved in and out
+ * 
+ * Does nothing if the index hasn't been built
+ */
+void AtmosphereIndex::add(std::string_view path, bool isFolder) {
+  if (this->built && this->complete) {
+    // Once something doesn't fit, the index can no longer say what isn't there:
+    this->complete = this->paths->insert(toKey(path, isFolder));
+  }
+}
+
+void AtmosphereIndex::remove(std::string_view path, bool isFolder) {
+  if (this->built) {
+    this->paths->erase(toKey(path, isFolder));
+  }
+}
+
+u64 AtmosphereIndex::toKey(std::string_view path, bool isFolder) {
+  u64 key = PathHashSet::hash(path);
+  return isFolder ? PathHashSet::hash("/", key) : key;
+}
+
+/**
+ * Checks the filesystem for the path (only used when the index can't answer)
+ */
+bool AtmosphereIndex::exists(std::string_view path, bool isFolder) const {
+  FsPath fullPath = FsPath(this->atmospherePath).append(path);
+  return isFolder ? FsManager::doesFolderExist(fullPath) : FsManager::doesFileExist(fullPath);
+}
@@ -0,0 +1,763 @@
+#include "catalog.h"
+
+#include "constants.h"
+#include "fs_manager.h"
+#include "meta_manager.h"
+#include "path_hash_set.h"
+
+#include <algorithm>
+
+/**
+ * Appends little-endian integers & length-prefixed strings to the catalog file's contents
+ */
+static void putInt(std::string& data, u64 value, int size) {
+  for (int i = 0; i < size; i++) {
+    data += (char) (value >> (i * 8) & 0xFF);
+  }
+}
+
+static void putString(std::string& data, std::string_view text) {
+  putInt(data, text.size(), 2);
+  data.append(text);
+}
+
+/**
+ * Reads what `putInt()`/`putString()` wrote, moving past it
+ *
+ * Returns false if the data ends first
+ */
+static bool takeInt(std::string_view& data, u64& value, int size) {
+  if (data.size() < (std::size_t) size) { return false; }
+
+  value = 0;
+  for (int i = 0; i < size; i++) {
+    value |= (u64) (u8) data[i] << (i * 8);
+  }
+  data.remove_prefix(size);
+  return true;
+}
+
+static bool takeString(std::string_view& data, std::string_view& text) {
+  u64 size;
+  if (!takeInt(data, size, 2) || data.size() < size) { return false; }
+
+  text = data.substr(0, size);
+  data.remove_prefix(size);
+  return true;
+}
+
+/**
+ * Sorts folder names by the names of the entities they belong to
+ */
+static void sortByName(std::vector<std::string>& folderNames) {
+  std::sort(folderNames.begin(), folderNames.end(), [](const std::string& a, const std::string& b) {
+    return MetaManager::parseFolderName(a).name < MetaManager::parseFolderName(b).name;
+  });
+}
+
+/**
+ * Reads the catalog from the file
+ *
+ * Returns false if there's no file or it can't be read (in which case the catalog is left empty)
+ */
+bool Catalog::load(const FsPath& path) {
+  this->clear();
+
+  FsManager::finishReplacingFile(path);
+  if (!FsManager::doesFileExist(path)) { return false; }
+
+  std::string contents = FsManager::readFile(path);
+  std::string_view data(contents);
+
+  if (!data.starts_with(CATALOG_MAGIC) || data.size() <= CATALOG_MAGIC.size() || (u8) data[CATALOG_MAGIC.size()] != CATALOG_VERSION) {
+    return false;
+  }
+  data.remove_prefix(CATALOG_MAGIC.size() + 1);
+
+  // Most of the pool is folder names, which take up most of the file:
+  this->pool.reserve(data.size());
+
+  u64 generation, groupCount, sourceCount, modCount, listingHash, modifiedTime, fileCount;
+  std::string_view name;
+  bool valid = takeInt(data, generation, 8) && takeInt(data, groupCount, 2);
+  this->generation = generation;
+
+  for (u64 g = 0; valid && g < groupCount; g++) {
+    valid = takeString(data, name) && takeInt(data, listingHash, 8) && takeInt(data, modifiedTime, 8) && takeInt(data, sourceCount, 2);
+    if (!valid) { break; }
+    this->addGroup(name, listingHash, modifiedTime);
+
+    for (u64 s = 0; valid && s < sourceCount; s++) {
+      valid = takeString(data, name) && takeInt(data, listingHash, 8) && takeInt(data, modifiedTime, 8) && takeInt(data, modCount, 2);
+      if (!valid) { break; }
+      this->addSource(name, listingHash, modifiedTime);
+
+      for (u64 m = 0; valid && m < modCount; m++) {
+        valid = takeString(data, name) && takeInt(data, fileCount, 4);
+        if (valid) {
+          this->addMod(name, fileCount);
+        }
+      }
+    }
+  }
+
+  if (!valid || !data.empty()) {
+    this->clear();
+    return false;
+  }
+
+  return true;
+}
+
+void Catalog::save(const FsPath& path) const {
+  std::string data = CATALOG_MAGIC;
+  data += (char) CATALOG_VERSION;
+
+  putInt(data, this->generation, 8);
+  putInt(data, this->groupNames.size(), 2);
+  for (u32 group : this->groups()) {
+    putString(data, this->groupName(group));
+    putInt(data, this->groupListingHashes[group], 8);
+    putInt(data, this->groupModifiedTimes[group], 8);
+    putInt(data, this->sourcesOf(group).size(), 2);
+
+    for (u32 source : this->sourcesOf(group)) {
+      putString(data, this->sourceFolderName(source));
+      putInt(data, this->sourceListingHashes[source], 8);
+      putInt(data, this->sourceModifiedTimes[source], 8);
+      putInt(data, this->modsOf(source).size(), 2);
+
+      for (u32 mod : this->modsOf(source)) {
+        putString(data, this->modFolderName(mod));
+        putInt(data, this->modFileCount(mod), 4);
+      }
+    }
+  }
+
+  FsManager::replaceFile(path, data);
+}
+
+/**
+ * Reads the active mods from the file
+ * 
+ * Returns false if there's no file, it can't be read, or it was saved for a different build of the catalog
+ * (in which case no mods are left active)
+ */
+bool Catalog::loadActiveMods(const FsPath& path) {
+  std::fill(this->sourceActiveMods.begin(), this->sourceActiveMods.end(), NONE);
+  std::fill(this->sourceLegacyLists.begin(), this->sourceLegacyLists.end(), false);
+
+  FsManager::finishReplacingFile(path);
+  if (!FsManager::doesFileExist(path)) { return false; }
+
+  std::string contents = FsManager::readFile(path);
+  std::string_view data(contents);
+
+  if (!data.starts_with(ACTIVE_MODS_MAGIC) || data.size() <= ACTIVE_MODS_MAGIC.size() || (u8) data[ACTIVE_MODS_MAGIC.size()] != ACTIVE_MODS_VERSION) {
+    return false;
+  }
+  data.remove_prefix(ACTIVE_MODS_MAGIC.size() + 1);
+
+  u64 generation, sourceCount;
+  if (!takeInt(data, generation, 8) || !takeInt(data, sourceCount, 4)) { return false; }
+  if (generation != this->generation || sourceCount != this->sourceNames.size() || data.size() != sourceCount * 3) { return false; }
+
+  for (u32 source = 0; source < sourceCount; source++) {
+    u64 position, legacy;
+    takeInt(data, position, 2);
+    takeInt(data, legacy, 1);
+
+    if (position == ACTIVE_MODS_NONE) { continue; }
+
+    if (position >= this->modsOf(source).size()) {
+      std::fill(this->sourceActiveMods.begin(), this->sourceActiveMods.end(), NONE);
+      std::fill(this->sourceLegacyLists.begin(), this->sourceLegacyLists.end(), false);
+      return false;
+    }
+    this->sourceActiveMods[source] = this->modsOf(source)[position];
+    this->sourceLegacyLists[source] = legacy;
+  }
+
+  return true;
+}
+
+void Catalog::saveActiveMods(const FsPath& path) const {
+  std::string data = ACTIVE_MODS_MAGIC;
+  data += (char) ACTIVE_MODS_VERSION;
+
+  putInt(data, this->generation, 8);
+  putInt(data, this->sourceNames.size(), 4);
+
+  for (u32 source = 0; source < this->sourceNames.size(); source++) {
+    u32 activeMod = this->activeMod(source);
+    putInt(data, activeMod == NONE ? ACTIVE_MODS_NONE : activeMod - this->sourceFirstMods[source], 2);
+    putInt(data, this->hasLegacyList(source), 1);
+  }
+
+  FsManager::replaceFile(path, data);
+}
+
+/**
+ * Reads the ratings & locks changed in the overlay, which take the place of what the folders' names say
+ * 
+ * Records for folders that have since been renamed (or removed) are ignored
+ */
+void Catalog::loadMetadata(const FsPath& path) {
+  FsManager::finishReplacingFile(path);
+  if (!FsManager::doesFileExist(path)) { return; }
+
+  std::string contents = FsManager::readFile(path);
+  std::string_view data(contents);
+
+  if (!data.starts_with(METADATA_MAGIC) || data.size() <= METADATA_MAGIC.size() || (u8) data[METADATA_MAGIC.size()] != METADATA_VERSION) {
+    return;
+  }
+  data.remove_prefix(METADATA_MAGIC.size() + 1);
+
+  u64 recordCount, kind, rating, locked;
+  std::string_view group, source, mod;
+  if (!takeInt(data, recordCount, 4)) { return; }
+
+  for (u64 i = 0; i < recordCount; i++) {
+    if (!takeInt(data, kind, 1) || !takeString(data, group) || !takeString(data, source)) { return; }
+
+    if (kind == METADATA_SOURCE) {
+      if (!takeInt(data, rating, 1) || !takeInt(data, locked, 1)) { return; }
+
+      u32 groupId = this->findGroup(group);
+      if (groupId == NONE) { continue; }
+
+      for (u32 sourceId : this->sourcesOf(groupId)) {
+        if (this->sourceFolderName(sourceId) == source) {
+          this->sourceRatings[sourceId] = rating;
+          this->sourceLocks[sourceId] = locked;
+          break;
+        }
+      }
+    } else {
+      if (!takeString(data, mod) || !takeInt(data, rating, 1)) { return; }
+
+      u32 sourceId = this->findSource(this->findGroup(group), source);
+      if (sourceId == NONE) { continue; }
+
+      for (u32 modId : this->modsOf(sourceId)) {
+        if (this->modFolderName(modId) == mod) {
+          this->modRatings[modId] = rating;
+          break;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Saves every rating & lock that's different from what its folder's name says, all in one write
+ */
+void Catalog::saveMetadata(const FsPath& path) const {
+  std::string records;
+  u32 recordCount = 0;
+
+  for (u32 group : this->groups()) {
+    for (u32 source : this->sourcesOf(group)) {
+      std::string_view folderName = this->sourceFolderName(source);
+      MetaManager::FolderName parsed = MetaManager::parseFolderName(folderName);
+
+      if (this->sourceRating(source) != parsed.rating || this->isSourceLocked(source) != parsed.locked) {
+        putInt(records, METADATA_SOURCE, 1);
+        putString(records, this->groupName(group));
+        putString(records, folderName);
+        putInt(records, this->sourceRating(source), 1);
+        putInt(records, this->isSourceLocked(source), 1);
+        recordCount++;
+      }
+
+      for (u32 mod : this->modsOf(source)) {
+        if (this->modRating(mod) != MetaManager::parseFolderName(this->modFolderName(mod)).rating) {
+          putInt(records, METADATA_MOD, 1);
+          putString(records, this->groupName(group));
+          putString(records, this->sourceName(source));
+          putString(records, this->modFolderName(mod));
+          putInt(records, this->modRating(mod), 1);
+          recordCount++;
+        }
+      }
+    }
+  }
+
+  std::string data = METADATA_MAGIC;
+  data += (char) METADATA_VERSION;
+  putInt(data, recordCount, 4);
+  data += records;
+
+  FsManager::replaceFile(path, data);
+}
+
+/**
+ * Finds the active mods again from the lists of moved files in each source's folder
+ * (without cataloging anything else again)
+ */
+void Catalog::findActiveMods(const FsPath& gamePath) {
+  std::string activeMod;
+
+  for (u32 group : this->groups()) {
+    FsPath groupPath = FsPath(gamePath).join(this->groupName(group));
+
+    for (u32 source : this->sourcesOf(group)) {
+      this->sourceActiveMods[source] = NONE;
+      this->sourceLegacyLists[source] = false;
+
+      FsManager::DirStream sourceDir(FsPath(groupPath).join(this->sourceFolderName(source)), FsDirOpenMode_ReadFiles);
+
+      while (FsDirectoryEntry* entry = sourceDir.next()) {
+        if (isMovedFilesList(*entry, activeMod)) {
+          this->sourceActiveMods[source] = this->findMod(source, activeMod);
+          this->sourceLegacyLists[source] = std::string_view(entry->name).ends_with(TXT_EXT);
+          break;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Walks through the game's folder to catalog everything in it from scratch
+ */
+void Catalog::build(const FsPath& gamePath) {
+  this->clear();
+  this->buildGroups(gamePath, nullptr);
+}
+
+/**
+ * Catalogs the game's folder again like `build()`, but only counts the files of mods that weren't in the catalog before
+ * (mods that were keep their file counts, even if their folders were renamed)
+ */
+void Catalog::update(const FsPath& gamePath) {
+  Catalog previous = std::move(*this);
+
+  this->clear();
+  this->buildGroups(gamePath, &previous);
+}
+
+/**
+ * Checks if the game's folder still has the same groups, and the same entries in each group & source
+ *
+ * Only folders modified since they were cataloged are read, comparing a hash of the names in them, so renaming
+ * something (such as editing a rating on a PC) is noticed too. What's inside mods' folders isn't checked.
+ * Changes made by Mod Alchemist itself are kept in the catalog as they're made.
+ *
+ * A folder that was modified without anything in it changing gets its new time recorded, so it isn't read again
+ * (timesUpdated is set if that happens, in which case the catalog should be saved).
+ */
+bool Catalog::isCurrent(const FsPath& gamePath, bool& timesUpdated) {
+  timesUpdated = false;
+
+  std::vector<std::string> groupNames = FsManager::listNames(gamePath, true);
+
+  if (groupNames.size() != this->groupNames.size()) { return false; }
+
+  for (u32 group : this->groups()) {
+    if (groupNames[group] != this->groupName(group)) { return false; }
+
+    FsPath groupPath = FsPath(gamePath).join(this->groupName(group));
+    if (!this->isListingCurrent(groupPath, FsDirOpenMode_ReadDirs, NONE, this->groupListingHashes[group], this->groupModifiedTimes[group], timesUpdated)) {
+      return false;
+    }
+
+    for (u32 source : this->sourcesOf(group)) {
+      FsPath sourcePath = FsPath(groupPath).join(this->sourceFolderName(source));
+      if (!this->isListingCurrent(
+        sourcePath, FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles, this->activeMod(source),
+        this->sourceListingHashes[source], this->sourceModifiedTimes[source], timesUpdated
+      )) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+Catalog::IdRange Catalog::groups() const {
+  return IdRange(0, this->groupNames.size());
+}
+
+Catalog::IdRange Catalog::sourcesOf(u32 group) const {
+  u32 end = group + 1 < this->groupFirstSources.size() ? this->groupFirstSources[group + 1] : this->sourceNames.size();
+  return IdRange(this->groupFirstSources[group], end);
+}
+
+Catalog::IdRange Catalog::modsOf(u32 source) const {
+  u32 end = source + 1 < this->sourceFirstMods.size() ? this->sourceFirstMods[source + 1] : this->modNames.size();
+  return IdRange(this->sourceFirstMods[source], end);
+}
+
+/**
+ * Finds an ID by name (returns NONE if there isn't one)
+ */
+u32 Catalog::findGroup(std::string_view name) const {
+  IdRange ids = this->groups();
+  auto found = std::ranges::lower_bound(ids, name, {}, [this](u32 id) { return this->groupName(id); });
+  return found != ids.end() && this->groupName(*found) == name ? *found : NONE;
+}
+
+u32 Catalog::findSource(u32 group, std::string_view name) const {
+  if (group == NONE) { return NONE; }
+
+  IdRange ids = this->sourcesOf(group);
+  auto found = std::ranges::lower_bound(ids, name, {}, [this](u32 id) { return this->sourceName(id); });
+  return found != ids.end() && this->sourceName(*found) == name ? *found : NONE;
+}
+
+u32 Catalog::findMod(u32 source, std::string_view name) const {
+  if (source == NONE) { return NONE; }
+
+  IdRange ids = this->modsOf(source);
+  auto found = std::ranges::lower_bound(ids, name, {}, [this](u32 id) { return this->modName(id); });
+  return found != ids.end() && this->modName(*found) == name ? *found : NONE;
+}
+
+std::string_view Catalog::groupName(u32 group) const {
+  return this->view(this->groupNames[group]);
+}
+
+std::string_view Catalog::sourceName(u32 source) const {
+  return this->view(this->sourceNames[source]);
+}
+
+std::string_view Catalog::sourceFolderName(u32 source) const {
+  return this->view(this->sourceFolderNames[source]);
+}
+
+u8 Catalog::sourceRating(u32 source) const {
+  return this->sourceRatings[source];
+}
+
+bool Catalog::isSourceLocked(u32 source) const {
+  return this->sourceLocks[source];
+}
+
+/**
+ * Gets the mod that's active for the source (NONE if no mod is active)
+ */
+u32 Catalog::activeMod(u32 source) const {
+  return this->sourceActiveMods[source];
+}
+
+/**
+ * Checks if the active mod's list of moved files is in the legacy text format (from an activation by an older version)
+ */
+bool Catalog::hasLegacyList(u32 source) const {
+  return this->sourceLegacyLists[source];
+}
+
+std::string_view Catalog::modName(u32 mod) const {
+  return this->view(this->modNames[mod]);
+}
+
+std::string_view Catalog::modFolderName(u32 mod) const {
+  return this->view(this->modFolderNames[mod]);
+}
+
+u8 Catalog::modRating(u32 mod) const {
+  return this->modRatings[mod];
+}
+
+/**
+ * Number of files in the mod
+ *
+ * If the mod was already active when it was counted, this is the number of
+ * files & folders in its list of moved files instead (folders moved as a whole count as 1)
+ */
+u32 Catalog::modFileCount(u32 mod) const {
+  return this->modFileCounts[mod];
+}
+
+/**
+ * Changes a rating/lock without renaming anything (saved with `saveMetadata()`)
+ */
+void Catalog::setSourceRating(u32 source, u8 rating) {
+  this->sourceRatings[source] = rating;
+}
+
+void Catalog::setSourceLocked(u32 source, bool locked) {
+  this->sourceLocks[source] = locked;
+}
+
+void Catalog::setModRating(u32 mod, u8 rating) {
+  this->modRatings[mod] = rating;
+}
+
+/**
+ * Keep the active mods up to date as mods are activated (or deactivated with NONE)
+ * 
+ * Mods activated now always get a list in the binary format
+ */
+void Catalog::setActiveMod(u32 source, u32 mod) {
+  this->sourceActiveMods[source] = mod;
+  this->sourceLegacyLists[source] = false;
+}
+
+void Catalog::clear() {
+  this->pool.clear();
+
+  this->groupNames.clear();
+  this->groupListingHashes.clear();
+  this->groupModifiedTimes.clear();
+  this->groupFirstSources.clear();
+
+  this->sourceFolderNames.clear();
+  this->sourceNames.clear();
+  this->sourceRatings.clear();
+  this->sourceLocks.clear();
+  this->sourceActiveMods.clear();
+  this->sourceLegacyLists.clear();
+  this->sourceListingHashes.clear();
+  this->sourceModifiedTimes.clear();
+  this->sourceFirstMods.clear();
+
+  this->modFolderNames.clear();
+  this->modNames.clear();
+  this->modRatings.clear();
+  this->modFileCounts.clear();
+}
+
+std::string_view Catalog::view(const PoolText& text) const {
+  return std::string_view(this->pool).substr(text.offset, text.length);
+}
+
+/**
+ * Adds a folder name to the pool, along with the name within it
+ */
+void Catalog::storeFolderName(std::string_view folderName, PoolText& folderText, PoolText& nameText) {
+  folderText = { (u32) this->pool.size(), (u16) folderName.size() };
+  this->pool.append(folderName);
+
+  // The name is the folder name without the lock character & rating:
+  std::string_view name = MetaManager::parseFolderName(folderName).name;
+  nameText = { (u32) (folderText.offset + (name.data() - folderName.data())), (u16) name.size() };
+}
+
+/**
+ * Adds an entry after the last one (a source goes in the last group added, and a mod in the last source added)
+ */
+void Catalog::addGroup(std::string_view name, u64 listingHash, u64 modifiedTime) {
+  this->groupNames.push_back({ (u32) this->pool.size(), (u16) name.size() });
+  this->pool.append(name);
+
+  this->groupListingHashes.push_back(listingHash);
+  this->groupModifiedTimes.push_back(modifiedTime);
+  this->groupFirstSources.push_back(this->sourceNames.size());
+}
+
+void Catalog::addSource(std::string_view folderName, u64 listingHash, u64 modifiedTime) {
+  PoolText folderText, nameText;
+  this->storeFolderName(folderName, folderText, nameText);
+
+  this->sourceFolderNames.push_back(folderText);
+  this->sourceNames.push_back(nameText);
+  MetaManager::FolderName parsed = MetaManager::parseFolderName(folderName);
+  this->sourceRatings.push_back(parsed.rating);
+  this->sourceLocks.push_back(parsed.locked);
+  this->sourceActiveMods.push_back(NONE);
+  this->sourceLegacyLists.push_back(false);
+  this->sourceListingHashes.push_back(listingHash);
+  this->sourceModifiedTimes.push_back(modifiedTime);
+  this->sourceFirstMods.push_back(this->modNames.size());
+}
+
+void Catalog::addMod(std::string_view folderName, u32 fileCount) {
+  PoolText folderText, nameText;
+  this->storeFolderName(folderName, folderText, nameText);
+
+  this->modFolderNames.push_back(folderText);
+  this->modNames.push_back(nameText);
+  this->modRatings.push_back(MetaManager::parseFolderName(folderName).rating);
+  this->modFileCounts.push_back(fileCount);
+}
+
+/**
+ * Catalogs every group in the game's folder, taking the file counts of mods from the previous catalog when it has them
+ */
+void Catalog::buildGroups(const FsPath& gamePath, const Catalog* previous) {
+  this->generation = armGetSystemTick();
+
+  for (const std::string& group : FsManager::listNames(gamePath, true)) {
+    FsPath groupPath = FsPath(gamePath).join(group);
+
+    // The time is read first, so anything changed while the folder is being read shows up as a change next time:
+    u64 modifiedTime = 0;
+    FsManager::getModifiedTime(groupPath, modifiedTime);
+
+    std::vector<std::string> sourceFolderNames;
+    u64 listingHash = 0;
+    FsManager::DirStream groupDir(groupPath, FsDirOpenMode_ReadDirs);
+
+    while (FsDirectoryEntry* entry = groupDir.next()) {
+      sourceFolderNames.push_back(entry->name);
+      listingHash += hashEntryName(entry->name);
+    }
+
+    sortByName(sourceFolderNames);
+
+    this->addGroup(group, listingHash, modifiedTime);
+    u32 previousGroup = previous == nullptr ? NONE : previous->findGroup(group);
+
+    for (const std::string& folderName : sourceFolderNames) {
+      u32 previousSource = previous == nullptr ? NONE : previous->findSource(previousGroup, MetaManager::parseFolderName(folderName).name);
+      this->buildSource(FsPath(groupPath).join(folderName), folderName, previous, previousSource);
+    }
+  }
+}
+
+/**
+ * Catalogs a source's folder, including the mods in it (previousSource is the same source in the previous catalog, or NONE)
+ */
+void Catalog::buildSource(const FsPath& sourcePath, std::string_view folderName, const Catalog* previous, u32 previousSource) {
+  std::vector<std::string> modFolderNames;
+  std::string activeMod;
+  std::string movedFilesListName;
+  u64 listingHash = 0;
+
+  u64 modifiedTime = 0;
+  FsManager::getModifiedTime(sourcePath, modifiedTime);
+
+  // The mods' folders and the active mod's list of moved files are all read in one pass:
+  FsManager::DirStream sourceDir(sourcePath, FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles);
+
+  while (FsDirectoryEntry* entry = sourceDir.next()) {
+    if (entry->type == FsDirEntryType_Dir) {
+      modFolderNames.push_back(entry->name);
+    } else if (activeMod.empty() && isMovedFilesList(*entry, activeMod)) {
+      // The list of moved files comes and goes with activations, so it isn't part of the hash:
+      movedFilesListName = entry->name;
+      continue;
+    }
+
+    listingHash += hashEntryName(entry->name);
+  }
+
+  sortByName(modFolderNames);
+
+  FsPath movedFilesListPath = movedFilesListName.empty() ? FsPath() : FsPath(sourcePath).join(movedFilesListName);
+
+  this->addSource(folderName, listingHash, modifiedTime);
+  for (const std::string& modFolderName : modFolderNames) {
+    std::string_view modName = MetaManager::parseFolderName(modFolderName).name;
+
+    // Walking through a mod's files is the slow part, so it's only done for mods that weren't cataloged before:
+    u32 previousMod = previous == nullptr ? NONE : previous->findMod(previousSource, modName);
+    if (previousMod != NONE) {
+      this->addMod(modFolderName, previous->modFileCount(previousMod));
+      continue;
+    }
+
+    bool isActive = modName == activeMod;
+    this->addMod(modFolderName, countModFiles(FsPath(sourcePath).join(modFolderName), isActive ? movedFilesListPath : FsPath()));
+  }
+
+  u32 source = this->sourceNames.size() - 1;
+  this->sourceActiveMods[source] = activeMod.empty() ? NONE : this->findMod(source, activeMod);
+  this->sourceLegacyLists[source] = this->sourceActiveMods[source] != NONE && movedFilesListName.ends_with(TXT_EXT);
+
+  // A list of moved files for a mod that no longer exists never goes away, so it's hashed like anything else:
+  if (!activeMod.empty() && this->sourceActiveMods[source] == NONE) {
+    this->sourceListingHashes[source] += hashEntryName(movedFilesListName);
+  }
+}
+
+/**
+ * Checks a folder's listing against its hash, unless the folder hasn't been modified since it was cataloged
+ * (the time is updated if it was modified but the listing is the same)
+ *
+ * @param activeMod The active mod, whose list of moved files isn't part of the hash (NONE for a group's folder)
+ */
+bool Catalog::isListingCurrent(const FsPath& path, u32 mode, u32 activeMod, u64 listingHash, u64& modifiedTime, bool& timesUpdated) const {
+  // Reading the time is a single call, where reading the folder takes several:
+  u64 currentTime = 0;
+  if (FsManager::getModifiedTime(path, currentTime)) {
+    if (currentTime == modifiedTime) { return true; }
+  } else if (!FsManager::doesFolderExist(path)) {
+    return false;
+  }
+
+  u64 currentHash = 0;
+  bool skippedList = false;
+  std::string listedMod;
+  FsManager::DirStream dir(path, mode);
+
+  while (FsDirectoryEntry* entry = dir.next()) {
+    // The active mod's list of moved files comes and goes with activations, so it isn't part of the hash:
+    if (activeMod != NONE && !skippedList && entry->type == FsDirEntryType_File
+      && isMovedFilesList(*entry, listedMod) && listedMod == this->modName(activeMod)) {
+      skippedList = true;
+      continue;
+    }
+
+    currentHash += hashEntryName(entry->name);
+  }
+
+  if (currentHash != listingHash) { return false; }
+
+  // Only the time changed (such as from a mod being activated), so the folder doesn't need to be read next time:
+  if (currentTime != modifiedTime) {
+    modifiedTime = currentTime;
+    timesUpdated = true;
+  }
+  return true;
+}
+
+/**
+ * Hashes a name in a folder's listing (a listing's hash is the sum of its names' hashes, so the order they're read in doesn't matter)
+ */
+u64 Catalog::hashEntryName(std::string_view name) {
+  return PathHashSet::hash(name);
+}
+
+/**
+ * Gets the name of the mod that's active according to the list of moved files, if the entry is one
+ */
+bool Catalog::isMovedFilesList(const FsDirectoryEntry& entry, std::string& mod) {
+  std::string_view name(entry.name);
+
+  if (name.ends_with(MANIFEST_EXT)) {
+    mod = name.substr(0, name.size() - MANIFEST_EXT.size());
+    return true;
+  }
+  if (name.ends_with(TXT_EXT)) {
+    mod = name.substr(0, name.size() - TXT_EXT.size());
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Counts the files in a mod (or what's in its list of moved files if it's active)
+ */
+u32 Catalog::countModFiles(const FsPath& modPath, const FsPath& movedFilesListPath) {
+  u32 count = 0;
+
+  if (!movedFilesListPath.empty()) {
+    FsManager::ManifestReader movedFilesList(movedFilesListPath);
+
+    std::string_view path;
+    bool isFolder;
+    while (movedFilesList.next(path, isFolder)) {
+      count++;
+    }
+
+    return count;
+  }
+
+  FsManager::TreeWalker walker(modPath);
+
+  while (FsDirectoryEntry* entry = walker.next()) {
+    if (entry->type == FsDirEntryType_Dir) {
+      walker.enter();
+    } else {
+      count++;
+    }
+  }
+
+  return count;
+}
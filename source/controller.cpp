@@ -1,8 +1,10 @@
 #include "controller.h"
 
 #include "constants.h"
+#include "diagnostics.h"
 #include "fs_manager.h"
 #include "meta_manager.h"
+#include "path_hash_set.h"
 
 #include "ui/ui_error.h"
 
@@ -17,10 +19,30 @@ void Controller::init() {
   GuiError::tryResult(pmdmntGetApplicationProcessId(&processId), "pmDmntPID");
   GuiError::tryResult(pminfoGetProgramId(&this->titleId, processId), "pmInfoPID");
 
+  // Build the paths specific to this game once, so they aren't rebuilt for every file operation:
+  std::string hexTitleId = MetaManager::getHexTitleId(this->titleId);
+  this->gamePath = FsPath(ALCHEMIST_PATH).append(hexTitleId);
+  this->atmospherePath = FsPath(ATMOSPHERE_PATH).append(hexTitleId);
+
   GuiError::tryResult(fsOpenSdCardFileSystem(&FsManager::sdSystem), "fsOpenSD");
 
   // Create the Atmosphere title ID folder for the current game
   FsManager::createFolderIfNeeded(this->getAtmospherePath());
+
+  // Needed to return folders moved as a whole, including when finishing an interrupted return:
+  this->folderOwners.load(this->getFolderOwnersPath());
+
+  // Finish anything that was interrupted the last time the overlay was open:
+  this->recoverJournal();
+
+  // Files may have changed while the overlay was closed, so the index is rebuilt when it's next needed:
+  this->atmosphereIndex.clear();
+
+  // Everything else is read from the catalog of the game's folder:
+  if (this->doesGameHaveFolder()) {
+    this->loadCatalog();
+    this->profiles.load(this->getProfilesPath());
+  }
 }
 
 /**
@@ -37,100 +59,67 @@ bool Controller::doesGameHaveFolder() {
   return FsManager::doesFolderExist(this->getGamePath());
 }
 
-// NOTE: vectors returned from functions in controller
-// are implied to be sorted alphabetically unless stated otherwise
-
 /**
- * Load all groups from the game folder
+ * Catalogs the game's folder again from scratch
  * 
- * @param sort Whether to sort the list of names alphabetically or not
- *             Can take considerable performance when in nested loops, so sometimes it's good to skip if not needed
+ * Only needed for changes made outside of Mod Alchemist inside mods' folders (such as adding files to a mod), which aren't checked when the catalog is loaded
  */
-std::vector<std::string> Controller::loadGroups(bool sort) {
-  return FsManager::listNames(this->getGamePath(), sort);
+void Controller::rescan() {
+  this->catalog.build(this->gamePath);
+  this->catalog.save(this->getCatalogPath());
+  this->catalog.saveActiveMods(this->getActiveModsPath());
+  this->catalog.loadMetadata(this->getMetadataPath());
 }
 
 /**
- * Load all source options within the specified group
- * 
- * @param sort Whether to sort the list of names alphabetically or not
- *             Can take considerable performance when in nested loops, so sometimes it's good to skip if not needed
- * 
- * @requirement: group must be set
+ * Gets the catalog of everything in the game's folder
  */
-std::vector<std::string> Controller::loadSources(bool sort) {
-  return FsManager::listNames(this->getGroupPath(), sort);
+const Catalog& Controller::getCatalog() {
+  return this->catalog;
 }
 
-/*
- * Gets an unsorted vector of only the sources that are unlocked
- * 
- * @requirement: group must be set
+/**
+ * Gets the game's saved profiles (see ProfileList)
  */
-std::vector<std::string> Controller::loadUnlockedSources() {
-  std::vector<std::string> sources;
-
-  FsDir dir = FsManager::openFolder(this->getGroupPath(), FsDirOpenMode_ReadDirs);
-
-  FsDirectoryEntry entry;
-  s64 readCount = 0;
-  while (R_SUCCEEDED(fsDirRead(&dir, &readCount, 1, &entry)) && readCount) {
-    if (entry.type == FsDirEntryType_Dir && !MetaManager::parseLockedStatus(entry.name)) {
-      sources.push_back(MetaManager::parseName(entry.name));
-    }
-  }
-
-  fsDirClose(&dir);
-
-  return sources;
+const ProfileList& Controller::getProfiles() {
+  return this->profiles;
 }
 
-/*
- * Checks if the source is locked from randomization
- *
- * @requirement: group must be set
+/**
+ * Saves the mods that are active now as a new profile
  */
-bool Controller::isSourceLocked(const std::string& source) {
-  bool isLocked;
-
-  FsDir dir = FsManager::openFolder(this->getGroupPath(), FsDirOpenMode_ReadDirs);
-
-  FsDirectoryEntry entry;
-  s64 readCount = 0;
-  while (R_SUCCEEDED(fsDirRead(&dir, &readCount, 1, &entry))) {
-    if (entry.type == FsDirEntryType_Dir && source == MetaManager::parseName(entry.name)) {
-      isLocked = MetaManager::parseLockedStatus(entry.name);
-      break;
-    }
-  }
+void Controller::addProfile() {
+  this->profiles.add(this->catalog);
+  this->profiles.save(this->getProfilesPath());
+}
 
-  fsDirClose(&dir);
+/**
+ * Replaces the profile's mods with the ones that are active now
+ */
+void Controller::updateProfile(u32 profile) {
+  this->profiles.update(profile, this->catalog);
+  this->profiles.save(this->getProfilesPath());
+}
 
-  return isLocked;
+void Controller::deleteProfile(u32 profile) {
+  this->profiles.remove(profile);
+  this->profiles.save(this->getProfilesPath());
 }
 
-/*
- * Load all source options within the specified group along with their lock status
+/**
+ * Fills the plan with the changes for the profile's mods to be active, only for the sources that differ from it
  * 
- * @requirement: group must be set
+ * The plan is emptied first, so the same one can be reused for each profile
  */
-std::map<std::string, bool> Controller::loadSourceLocks() {
-  std::map<std::string, bool> locks;
-
-  FsDir dir = FsManager::openFolder(this->getGroupPath(), FsDirOpenMode_ReadDirs);
-
-  FsDirectoryEntry entry;
-  s64 readCount = 0;
-  while (R_SUCCEEDED(fsDirRead(&dir, &readCount, 1, &entry)) && readCount) {
-    if (entry.type == FsDirEntryType_Dir) {
-      std::string source = MetaManager::parseName(entry.name);
-      locks[source] = MetaManager::parseLockedStatus(entry.name);
-    }
-  }
-
-  fsDirClose(&dir);
+void Controller::planProfile(u32 profile, RandomPlan& plan) {
+  this->profiles.plan(profile, this->catalog, plan);
+}
 
-  return locks;
+/**
+ * Counts files & folders moved from now on in the progress (or stops counting with nullptr)
+ */
+void Controller::setProgress(Progress* progress) {
+  this->progress = progress;
 }
 
 /*
@@ -139,16 +128,8 @@ std::map<std::string, bool> Controller::loadSourceLocks() {
  * @requirement: group must be set
  * @requirement: source must not already be locked
  */
-void Controller::lockSource(const std::string& source) {
-  u8 rating = this->loadDefaultRating(source);
-
-  std::string currentPath = this->getGroupPath() + "/" + MetaManager::buildFolderName(source, rating, false);
-  std::string newPath = this->getGroupPath() + "/" + MetaManager::buildFolderName(source, rating, true);
-
-  GuiError::tryResult(
-    fsFsRenameDirectory(&FsManager::sdSystem, FsManager::toPathBuffer(currentPath).get(), FsManager::toPathBuffer(newPath).get()),
-    "fsLock"
-  );
+void Controller::lockSource(u32 source) {
+  this->setSourceLocked(source, true);
 }
 
 /*
@@ -157,447 +138,583 @@ void Controller::lockSource(const std::string& source) {
  * @requirement: group must be set
  * @requirement: source must be currently locked
  */
-void Controller::unlockSource(const std::string& source) {
-  u8 rating = this->loadDefaultRating(source);
+void Controller::unlockSource(u32 source) {
+  this->setSourceLocked(source, false);
+}
 
-  std::string currentPath = this->getGroupPath() + "/" + MetaManager::buildFolderName(source, rating, true);
-  std::string newPath = this->getGroupPath() + "/" + MetaManager::buildFolderName(source, rating, false);
+/*
+ * Saves the ratings for each mod, along with the rating for using no mod for the current source
+ * 
+ * Nothing is written unless one of them changed
+ * 
+ * @requirement: group and source must be set
+ */
+void Controller::saveRatings(const std::pmr::map<u32, u8>& ratings, u8 defaultRating) {
+  bool changed = false;
+
+  for (const auto& [mod, rating]: ratings) {
+    if (rating != this->catalog.modRating(mod)) {
+      this->catalog.setModRating(mod, rating);
+      changed = true;
+    }
+  }
+
+  if (defaultRating != this->catalog.sourceRating(this->source)) {
+    this->catalog.setSourceRating(this->source, defaultRating);
+    changed = true;
+  }
 
-  GuiError::tryResult(
-    fsFsRenameDirectory(&FsManager::sdSystem, FsManager::toPathBuffer(currentPath).get(), FsManager::toPathBuffer(newPath).get()),
-    "fsUnlock"
-  );
+  // However many ratings changed, they're all saved in one write:
+  if (changed) {
+    this->catalog.saveMetadata(this->getMetadataPath());
+  }
 }
 
 /**
- * Load all mod options that could be activated for the moddable source in the group
+ * Activates the specified mod, moving all its files into the atmosphere folder for the game
  * 
- * @param sort Whether to sort the list of names alphabetically or not
- *             Can take considerable performance when in nested loops, so sometimes it's good to skip if not needed
+ * Make sure to deactivate any existing active mod for this source if there is one
  * 
- * @requirement: group and source must be set
+ * Mod won't be activated if EVERY file belonging to it has a conflict with a file already in the atmosphere folder
+ * 
+ * @requirement:
+ *  - group and source must be set
+ *  - "mod" parameter must not currently be active
+ *  - the title ID folder for the current game must already exist in Atmosphere's "content" folder
  */
-std::vector<std::string> Controller::loadMods(bool sort) {
-  return FsManager::listNames(this->getSourcePath(), sort);
+void Controller::activateMod(u32 mod) {
+  this->activateModJob(mod).run();
 }
 
-
-/*
- * Loads map of mods names to each rating
- * 
- * @requirement: group and source must be set
+/**
+ * Same as `activateMod()`, except it pauses after each entry in the mod's folder & each file/folder moved
  */
-std::map<std::string, u8> Controller::loadRatings() {
-  std::map<std::string, u8> ratings;
+Job Controller::activateModJob(u32 mod) {
+  DIAGNOSE("activateMod");
 
-  FsDir dir = FsManager::openFolder(this->getSourcePath(), FsDirOpenMode_ReadDirs);
+  // Path to the "mod" folder in alchemy's directory:
+  FsPath modPath = this->getModPath(mod);
+  FsPath movedFilesListPath = this->getMovedFilesListFilePath(mod);
 
-  FsDirectoryEntry entry;
-  s64 readCount = 0;
-  while (R_SUCCEEDED(fsDirRead(&dir, &readCount, 1, &entry)) && readCount) {
-    if (entry.type == FsDirEntryType_Dir) {
-      std::string mod = MetaManager::parseName(entry.name);
-      ratings[mod] = MetaManager::parseRating(entry.name);
-    }
-  }
+  // If this gets interrupted, every file recorded so far gets returned the next time the overlay is opened:
+  this->beginJournal(modPath, movedFilesListPath);
 
-  fsDirClose(&dir);
+  // Whether any file/folder was moved (nothing is if every one of them conflicts):
+  bool recordedAny = false;
 
-  return ratings;
-}
+  // The list is closed at the end of this block, so it can be removed if nothing was recorded in it:
+  {
+    // The list of moved files for the active mod.
+    // Paths are buffered in blocks, and each block's files are only moved once it has been written,
+    // so a file is never moved without a record of it:
+    FsManager::ManifestWriter movedFilesList(movedFilesListPath);
 
-/*
- * Loads the rating for the source (for using no mod)
- * 
- * @requirement: group must be set
- */
-u8 Controller::loadDefaultRating(const std::string& source) {
-  u8 rating;
+    // Visits each entry in the mod's folder tree once, keeping only one folder open for each level of depth:
+    FsManager::TreeWalker walker(modPath);
 
-  FsDir dir = FsManager::openFolder(this->getGroupPath(), FsDirOpenMode_ReadDirs);
+    // Where the current entry will be moved to in Atmosphere's folder:
+    FsPath toPath = this->atmospherePath;
+    std::size_t atmosphereLength = toPath.length();
 
-  FsDirectoryEntry entry;
-  s64 readCount = 0;
-  while (R_SUCCEEDED(fsDirRead(&dir, &readCount, 1, &entry))) {
-    if (entry.type == FsDirEntryType_Dir && source == MetaManager::parseName(entry.name)) {
-      rating = MetaManager::parseRating(entry.name);
-      break;
+    // Conflicts are checked against the index of what's in Atmosphere's folder
+    // (kept up to date afterwards, so activating many mods in a row only builds it once):
+    if (!this->atmosphereIndex.isBuilt()) {
+      this->atmosphereIndex.build(this->atmospherePath, this->folderOwners);
     }
+
+    while (FsDirectoryEntry* entry = walker.next()) {
+      co_await Job::pause();
+
+      std::string_view basePath = walker.relativePath();
+      toPath.truncate(atmosphereLength);
+      toPath.append(basePath);
+
+      // If the next entry is a file, we will move it and record it as moved as long as there isn't a conflict.
+      //
+      // File size has to be compared for rare cases where folder is incorrectly categorized as a file.
+      // In these cases, the entry loaded is corrupt, so we have to skip it and not load the mod files within it.
+      if (entry->type == FsDirEntryType_File && entry->file_size > 0) {
+
+        // If a file already exists in the location we'll move it to, there's a conflict:
+        bool fileConflict = this->atmosphereIndex.contains(basePath, false);
+        if (!fileConflict) {
+          // Record the file we're moving (it's moved along with the rest of its block, which is written out first if it's full):
+          if (!movedFilesList.fits(basePath)) {
+            co_await this->moveRecorded(movedFilesList, modPath);
+          }
+          movedFilesList.add(basePath, false);
+          recordedAny = true;
+          this->atmosphereIndex.add(basePath, false);
+        }
+      // If the next entry is a folder, we will move it or traverse within it:
+      } else if (entry->type == FsDirEntryType_Dir) {
+
+        // If Atmosphere's folder has nothing where this folder goes, nothing in it can conflict,
+        // so the whole folder is moved at once instead of file by file:
+        if (!this->atmosphereIndex.contains(basePath, true)) {
+          if (!movedFilesList.fits(basePath)) {
+            co_await this->moveRecorded(movedFilesList, modPath);
+          }
+          movedFilesList.add(basePath, true);
+          recordedAny = true;
+
+          // Saved along with the block it's in, before the folder is moved (see moveRecorded()):
+          this->folderOwners.add(basePath, this->catalog.groupName(this->group), this->catalog.sourceName(this->source), this->catalog.modName(mod));
+          this->atmosphereIndex.add(basePath, true);
+          continue;
+        }
+
+        // If the folder there was moved as a whole by another mod, split it up before adding files to it:
+        if (this->folderOwners.contains(basePath)) {
+          this->releaseMovedFolder(toPath);
+        }
+
+        walker.enter();
+      }
+    }
+
+    // Move whatever is recorded in the last block:
+    co_await this->moveRecorded(movedFilesList, modPath);
   }
 
-  fsDirClose(&dir);
+  // With nothing in place, the mod isn't active (which the caller can tell from the catalog):
+  if (!recordedAny) {
+    FsManager::deleteFileIfExists(movedFilesListPath);
+    this->endJournal();
+    co_return;
+  }
+
+  this->endJournal();
 
-  return rating;
+  this->catalog.setActiveMod(this->source, mod);
+  this->saveActiveMods();
 }
 
-/*
- * Saves the ratings for each mod
+/**
+ * Deactivates the currently active mod, restoring the moddable source to its vanilla state
  * 
  * @requirement: group and source must be set
  */
-void Controller::saveRatings(const std::map<std::string, u8>& ratings) {
-  for (const auto& [mod, rating]: ratings) {
-    std::string currentPath = this->getModPath(mod);
-    std::string newPath = this->getSourcePath() + "/" + MetaManager::buildFolderName(mod, rating, false);
-
-    GuiError::tryResult(
-      fsFsRenameDirectory(&FsManager::sdSystem, FsManager::toPathBuffer(currentPath).get(), FsManager::toPathBuffer(newPath).get()),
-      "fsRatingChange"
-    );
-  }
+void Controller::deactivateMod() {
+  this->deactivateModJob().run();
 }
 
-/*
- * Saves the rating for using no mod for the current source
+/**
+ * Same as `deactivateMod()`, except it pauses after each file/folder moved
  */
-void Controller::saveDefaultRating(const u8& rating) {
-  bool isLocked = this->isSourceLocked(this->source);
-  std::string newPath = this->getGroupPath() + "/" + MetaManager::buildFolderName(this->source, rating, isLocked);
+Job Controller::deactivateModJob() {
+  u32 activeMod = this->catalog.activeMod(this->source);
+
+  // If no active mod:
+  if (activeMod == Catalog::NONE) { co_return; }
 
-  GuiError::tryResult(
-    fsFsRenameDirectory(&FsManager::sdSystem, FsManager::toPathBuffer(this->getSourcePath()).get(), FsManager::toPathBuffer(newPath).get()),
-    "fsRatingChange"
-  );
+  co_await this->returnFilesJob(activeMod);
 }
 
 /**
- * Gets the mod currently activated for the source
- *
- * Returns an empty string if no mod is active and vanilla files are being used
+ * Deactivates every active mod in the game, going straight to the sources the catalog has an active mod for
  * 
- * @requirement: group and must be set
- */
-std::string Controller::getActiveMod(const std::string& source) {
-
-  // Open to the correct source directory
-  std::string groupPath = this->getGroupPath();
-  FsDir sourceDir = FsManager::openFolder(
-    groupPath + "/" + FsManager::getFolderName(groupPath, source),
-    FsDirOpenMode_ReadFiles
-  );
-
-  FsDirectoryEntry entry;
-  s64 readCount = 0;
-  std::string activeMod = "";
-  std::string name;
-
-  // Find the .txt file in the directory. The name would be the active mod:
-  while (R_SUCCEEDED(fsDirRead(&sourceDir, &readCount, 1, &entry)) && readCount) {
-    if (entry.type == FsDirEntryType_File) {
-      name = entry.name;
-      if (name.find(TXT_EXT) != std::string::npos) {
-        activeMod = name.substr(0, name.size() - TXT_EXT.size());
-        break;
-      }
+ * Progress is counted in sources, and checked for cancelling between them
+ */
+void Controller::deactivateAll(Progress& progress) {
+  DIAGNOSE("deactivateAll");
+
+  // The active mods are only saved once everything is done:
+  this->holdActiveMods = true;
+  this->setProgress(&progress);
+  progress.total = this->activeSourceCount();
+
+  // Only the catalog's table of active mods is checked, so no folder is read unless it has a mod to return:
+  for (u32 group : this->catalog.groups()) {
+    for (u32 source : this->catalog.sourcesOf(group)) {
+      if (progress.cancelled) { break; }
+
+      u32 activeMod = this->catalog.activeMod(source);
+      if (activeMod == Catalog::NONE) { continue; }
+
+      this->group = group;
+      this->source = source;
+      this->returnFiles(activeMod);
+
+      progress.done++;
     }
   }
 
-  fsDirClose(&sourceDir);
+  this->group = Catalog::NONE;
+  this->source = Catalog::NONE;
 
-  return activeMod;
+  this->setProgress(nullptr);
+  this->holdActiveMods = false;
+  this->saveActiveMods();
 }
 
 /**
- * Activates the specified mod, moving all its files into the atmosphere folder for the game
- * 
- * Make sure to deactivate any existing active mod for this source if there is one
- * 
- * Mod won't be activated if EVERY file belonging to it has a conflict with a file already in the atmosphere folder
- * 
- * @requirement:
- *  - group and source must be set
- *  - "mod" parameter must not currently be active
- *  - the title ID folder for the current game must already exist in Atmosphere's "content" folder
+ * Number of sources in the game that have a mod active
  */
-void Controller::activateMod(const std::string& mod) {
-
-  // Path to the "mod" folder in alchemy's directory:
-  std::string modPath = this->getModPath(mod);
-  // The txt file for the active mod:
-  FsFile movedFilesFile = FsManager::initFile(this->getMovedFilesListFilePath(mod));
-
-  FsDir dir = FsManager::openFolder(modPath, FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles);
+u32 Controller::activeSourceCount() const {
+  u32 count = 0;
+  for (u32 group : this->catalog.groups()) {
+    for (u32 source : this->catalog.sourcesOf(group)) {
+      if (this->catalog.activeMod(source) != Catalog::NONE) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
 
-  // Iterartor for current entry in the current directory:
-  short i = 0;
+/**
+ * Draws which mod to use for each unlocked source at random (based upon their ratings), without moving anything yet
+ * 
+ * @param resource Where the plan's list of changes is allocated
+ */
+RandomPlan Controller::planRandom(std::pmr::memory_resource* resource) {
+  RandomPlan plan(resource);
+  plan.draw(this->catalog);
+  return plan;
+}
 
-  // Used for "storing" where the iteration left off at when traversing deeper into the hierarchy:
-  std::vector<u64> iStorage;
+/**
+ * Activates/deactivates mods to match the plan, only touching the sources whose pick changed
+ * 
+ * Progress is counted in sources, and checked for cancelling between them
+ * (so each source is always left either fully activated or fully deactivated)
+ */
+void Controller::applyPlan(const RandomPlan& plan, Progress& progress) {
+  DIAGNOSE("applyPlan");
 
-  // The path we are currently at relative to the mod path.
-  // Empty string is mod path itself:
-  std::string currentBasePath = "";
+  // The active mods are only saved once everything is done:
+  this->holdActiveMods = true;
+  this->setProgress(&progress);
+  progress.total = plan.changes().size();
 
-  // Position in the txt file where we should write the next file path:
-  s64 txtOffset = 0;
+  for (const RandomPlan::Change& change : plan.changes()) {
+    if (progress.cancelled) { break; }
 
-  // The index of the current entry we're iterating over in the current directory:
-  short entryIndex = 0;
+    this->group = change.group;
+    this->source = change.source;
 
-  // The current number of files read at a time
-  // It reads 1 at a time, so it will always be either 1 or 0 (0 if all have been read)
-  s64 readCount = 0;
+    // A source that already matches (such as one changed since the plan was made) still counts as done:
+    u32 activeMod = this->catalog.activeMod(change.source);
+    if (activeMod != change.mod) {
+      if (activeMod != Catalog::NONE) {
+        this->returnFiles(activeMod);
+      }
+      if (change.mod != Catalog::NONE) {
+        this->activateMod(change.mod);
+      }
+    }
 
-  FsDirectoryEntry entry;
+    progress.done++;
+  }
 
-  while (R_SUCCEEDED(fsDirRead(&dir, &readCount, 1, &entry))) {
+  this->group = Catalog::NONE;
+  this->source = Catalog::NONE;
 
-    // Continue iterating the index until it catches up with the iteration we should be on (if needed):
-    entryIndex++;
-    if (entryIndex > i) {
-      i++;
+  this->setProgress(nullptr);
+  this->holdActiveMods = false;
+  this->saveActiveMods();
 
-      if (readCount > 0) {
-        std::string nextPath = currentBasePath + "/" + entry.name;
+  // Every activation in the plan has used the index by now:
+  this->releaseAtmosphereIndex();
+}
 
-        // If the next entry is a file, we will move it and record it as moved as long as there isn't a conflict.
-        //
-        // File size has to be compared for rare cases where folder is incorrectly categorized as a file.
-        // In these cases, the entry loaded is corrupt, so we have to skip it and not load the mod files within it.
-        if (entry.type == FsDirEntryType_File && entry.file_size > 0) {
+/**
+ * Frees the index of Atmosphere's folder once a run of activations is done (the next activation builds it again)
+ */
+void Controller::releaseAtmosphereIndex() {
+  this->atmosphereIndex.clear();
+}
 
-          // If a file already exists in the location we'll move it to, there's a conflict:
-          bool fileConflict = FsManager::doesFileExist(this->getAtmospherePath() + nextPath);
-          if (!fileConflict) {
-            // Record the file we're moving, and move it:
-            FsManager::write(movedFilesFile, nextPath + "\n", txtOffset);
-            FsManager::moveFile(modPath + nextPath, this->getAtmospherePath() + nextPath);
-          }
-        // If the next entry is a folder, we will traverse within it:
-        } else if (entry.type == FsDirEntryType_Dir) {
-          FsManager::createFolderIfNeeded(this->getAtmospherePath() + nextPath);
+/**
+ * Unmount SD card when destroyed 
+ */
+Controller::~Controller() {
+  fsFsClose(&FsManager::sdSystem);
+}
 
-          // Add the current count to the storage:
-          iStorage.push_back(i);
+/**
+ * Returns all files belonging to a mod from the atmosphere active mods folder to their original location
+ * 
+ * Essentially the same as deactivating the mod, except this can't be used with the default mod option.
+ */
+void Controller::returnFiles(u32 mod) {
+  this->returnFilesJob(mod).run();
+}
 
-          currentBasePath = nextPath;
-          FsManager::changeFolder(dir, modPath + nextPath, FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles);
+/**
+ * Same as `returnFiles()`, except it pauses after each file/folder moved
+ */
+Job Controller::returnFilesJob(u32 mod) {
+  DIAGNOSE("returnFiles");
+  FsPath movedFilesListPath = this->getMovedFilesListFilePath(mod);
+  FsPath modPath = this->getModPath(mod);
+
+  // If this gets interrupted, the rest of the files get returned the next time the overlay is opened:
+  this->beginJournal(modPath, movedFilesListPath);
+  co_await this->returnListed(movedFilesListPath, modPath);
+  this->endJournal();
+
+  this->catalog.setActiveMod(this->source, Catalog::NONE);
+  this->saveActiveMods();
+}
 
-          // Reset the index & iterator because we're starting in a new folder:
-          entryIndex = 0;
-          i = 0;
+/**
+ * Returns everything in a list of moved files from the atmosphere folder to the mod's folder (pausing after each one), then deletes the list
+ * 
+ * Anything listed that's no longer in the atmosphere folder (such as when finishing an interrupted return) is skipped
+ * (anything else that can't be moved back is an error, and the list is kept so nothing is lost)
+ */
+Job Controller::returnListed(const FsPath& movedFilesListPath, const FsPath& modPath) {
+
+  // Where each entry currently is in Atmosphere's folder, and where it's going back to:
+  FsPath fromPath = this->atmospherePath;
+  FsPath toPath = modPath;
+
+  // An activation can be interrupted before its list is even created:
+  if (FsManager::doesFileExist(movedFilesListPath)) {
+    // Read the list of files that were moved to atmosphere's folder.
+    // It stays open for the whole return, and is read in large chunks:
+    FsManager::ManifestReader movedFilesList(movedFilesListPath);
+
+    std::string_view basePath;
+    bool isFolder;
+    while (movedFilesList.next(basePath, isFolder)) {
+      fromPath.truncate(this->atmospherePath.length());
+      fromPath.append(basePath);
+      toPath.truncate(modPath.length());
+      toPath.append(basePath);
+
+      if (isFolder) {
+        // Move the folder back as a whole if it's still only this mod's.
+        // Otherwise, it was split up by another mod, and its contents are recorded individually later in the list:
+        if (this->folderOwners.contains(basePath) && FsManager::moveFolderIfExists(fromPath, toPath)) {
+          this->atmosphereIndex.remove(basePath, true);
+        } else {
+          FsManager::createFolderIfNeeded(toPath);
         }
-      } else {
-        // If there's nothing left in our count storage, we've navigated everything, so we're done:
-        if (iStorage.size() == 0) { break; }
-
-        // Otherwise, let's get back the count data of where we left off in the parent:
-        i = iStorage.back();
-        iStorage.pop_back();
 
-        // Remove the string portion after the last '/' to get the parent's path:
-        std::size_t lastSlashIndex = currentBasePath.rfind('/');
-        currentBasePath = currentBasePath.substr(0, lastSlashIndex);
-        FsManager::changeFolder(dir, modPath + currentBasePath, FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles);
-
-        // Reset the entry index because it will start at the beginning again:
-        entryIndex = 0;
+        this->folderOwners.remove(basePath);
+      } else {
+        // Move the file back to the mod's folder:
+        FsManager::moveFileIfExists(fromPath, toPath);
+        this->atmosphereIndex.remove(basePath, false);
       }
-    }
 
+      if (this->progress) { this->progress->files++; }
+      co_await Job::pause();
+    }
   }
 
-  fsFileClose(&movedFilesFile);
-  fsDirClose(&dir);
+  // Once all the files have been returned, delete the list:
+  this->folderOwners.save(this->getFolderOwnersPath());
+  FsManager::deleteFileIfExists(movedFilesListPath);
 }
 
 /**
- * Deactivates the currently active mod, restoring the moddable source to its vanilla state
- * 
- * @requirement: group and source must be set
+ * Records that files are about to be moved for the mod, along with the list of moved files they're recorded in
  */
-void Controller::deactivateMod() {
-  std::string activeMod(this->getActiveMod(this->source));
+void Controller::beginJournal(const FsPath& modPath, const FsPath& movedFilesListPath) {
+  std::string journal;
+  journal.append(modPath.view()).append("\n").append(movedFilesListPath.view()).append("\n");
 
-  // If no active mod:
-  if (activeMod.empty()) { return; }
+  // The hash of both paths goes last, so a journal that was cut off while being written is never mistaken for a whole one:
+  journal.append(std::to_string(PathHashSet::hash(journal))).append("\n");
 
-  this->returnFiles(activeMod);
+  FsManager::writeFile(this->getJournalPath(), journal);
 }
 
-void Controller::deactivateAll() {
-  std::vector<std::string> groups = this->loadGroups(false);
+/**
+ * Clears the journal once the files recorded in it are all where they should be
+ */
+void Controller::endJournal() {
+  FsManager::deleteFile(this->getJournalPath());
+}
 
-  for (const std::string& group : groups) {
-    this->group = group;
-    std::vector<std::string> sources = this->loadSources(false);
+/**
+ * Finishes an activation/return that was interrupted (such as by a crash or the console turning off)
+ * 
+ * Either way, every file in its list is returned to the mod's folder, leaving the mod inactive
+ */
+void Controller::recoverJournal() {
+  FsPath journalPath = this->getJournalPath();
+  if (!FsManager::doesFileExist(journalPath)) { return; }
 
-    for (const std::string& source : sources) {
-      this->source = source;
-      std::string activeMod(this->getActiveMod(source));
+  // The journal holds the mod's folder and its list of moved files, then the hash of both (one per line):
+  std::string journal = FsManager::readFile(journalPath);
+  std::size_t modEnd = journal.find('\n');
+  std::size_t listEnd = journal.find('\n', modEnd + 1);
 
-      if (!activeMod.empty()) {
-        this->returnFiles(activeMod);
-      }
-    }
+  // Only use the journal if it was written completely (nothing is moved until it is, so otherwise there's nothing to finish):
+  std::string_view paths = std::string_view(journal).substr(0, listEnd == std::string::npos ? 0 : listEnd + 1);
+  bool complete = modEnd != std::string::npos && listEnd != std::string::npos
+    && std::string_view(journal).substr(listEnd + 1) == std::to_string(PathHashSet::hash(paths)) + "\n";
+
+  if (complete) {
+    FsPath modPath(std::string_view(journal).substr(0, modEnd));
+    FsPath movedFilesListPath(std::string_view(journal).substr(modEnd + 1, listEnd - modEnd - 1));
+
+    this->returnListed(movedFilesListPath, modPath).run();
   }
 
-  this->group = "";
-  this->source = "";
+  // The mod may have been recorded as active already, so the active mods are found again
+  // (including from a replacement of the file that was being written):
+  FsManager::finishReplacingFile(this->getActiveModsPath());
+  FsManager::deleteFileIfExists(this->getActiveModsPath());
+
+  this->endJournal();
 }
 
 /**
- * Randomly activates/deactivates all mods based upon their ratings
+ * Writes out the current block of the list of moved files,
+ * then moves each file/folder recorded in it from the mod's folder into Atmosphere's folder (pausing after each one)
  */
-void Controller::randomize() {
-  
-  // Seed the random number generator with the current time
-  std::srand(static_cast<unsigned int>(std::time(nullptr)));
-
-  std::vector<std::string> groups = this->loadGroups(false);
-
-  for (const std::string& group : groups) {
-    this->group = group;
-    std::vector<std::string> sources = this->loadUnlockedSources();
-
-    for (const std::string& source : sources) {
-      this->source = source;
-      this->pickMod();
+Job Controller::moveRecorded(FsManager::ManifestWriter& movedFilesList, const FsPath& modPath) {
+  movedFilesList.flush();
+
+  // Folders in the block are owned before they're moved, so another mod never mixes its files into them unnoticed:
+  this->folderOwners.save(this->getFolderOwnersPath());
+
+  FsPath fromPath = modPath;
+  FsPath toPath = this->atmospherePath;
+
+  std::string_view basePath;
+  bool isFolder;
+  while (movedFilesList.nextFlushed(basePath, isFolder)) {
+    fromPath.truncate(modPath.length());
+    fromPath.append(basePath);
+    toPath.truncate(this->atmospherePath.length());
+    toPath.append(basePath);
+
+    if (isFolder) {
+      FsManager::moveFolder(fromPath, toPath);
+    } else {
+      FsManager::moveFile(fromPath, toPath);
     }
-  }
 
-  this->group = "";
-  this->source = "";
+    if (this->progress) { this->progress->files++; }
+    co_await Job::pause();
+  }
 }
 
 /**
- * Randomly activates a mod from the current group and source
+ * Splits up a folder that another mod moved into Atmosphere's folder as a whole,
+ * recording everything in it under that mod's list of moved files individually instead
  * 
- * @requirement: group and source must be set
+ * Needed before adding any other mod's files to the folder,
+ * otherwise they would be taken along when the other mod moves the folder back
+ * 
+ * If the owner's list of moved files can't be found, the folder's record is dropped instead
  */
-void Controller::pickMod() {
-  std::map<std::string, u8> ratings = this->loadRatings();
-  u8 defaultRating = this->loadDefaultRating(this->source);
+void Controller::releaseMovedFolder(const FsPath& folderPath) {
 
-  // Sum all ratings to pick one at random:
-  u16 ratingTotal = defaultRating;
-  for (const auto& [mod, rating]: ratings) {
-    ratingTotal += rating;
-  }
+  // The folder's path relative to the game's Atmosphere folder:
+  std::string_view basePath = folderPath.view().substr(this->atmospherePath.length());
 
-  // Just treat it as locked if all ratings are 0 for some reason:
-  if (ratingTotal == 0) { return; }
+  // Copied, since the owner's record is replaced below:
+  FolderOwners::Owner owner = *this->folderOwners.find(basePath);
 
-  // Get the random number 
-  u16 randomChoice = (std::rand() % ratingTotal) + 1;
+  // Find the owner's list of moved files:
+  u32 ownerGroupId = this->catalog.findGroup(owner.group);
+  u32 ownerSourceId = ownerGroupId == Catalog::NONE ? Catalog::NONE : this->catalog.findSource(ownerGroupId, owner.source);
+  u32 ownerModId = ownerSourceId == Catalog::NONE ? Catalog::NONE : this->catalog.findMod(ownerSourceId, owner.mod);
 
-  // If it's within the default option's range, deactivate it:
-  if (randomChoice <= defaultRating) {
-    this->deactivateMod();
-  } else {
-    // Otherwise, keep subtracting the ratings until we reach the one to activate:
-    randomChoice -= defaultRating;
+  FsPath ownerListPath;
+  if (ownerModId != Catalog::NONE) {
+    FsPath ownerSourcePath = FsPath(this->gamePath).join(owner.group).join(this->catalog.sourceFolderName(ownerSourceId));
+    bool legacy = this->catalog.activeMod(ownerSourceId) == ownerModId && this->catalog.hasLegacyList(ownerSourceId);
+    ownerListPath = this->getMovedFilesListFilePath(ownerSourcePath, owner.mod, legacy);
+  }
 
-    for (const auto& [mod, rating]: ratings) {
-      if (randomChoice < rating) {
-        std::string activeMod = this->getActiveMod(this->source);
+  // If the owner (or its list) is gone, nothing would ever move the folder back, so the record is just stale.
+  // It's dropped rather than creating a list for it:
+  if (ownerModId == Catalog::NONE || !FsManager::doesFileExist(ownerListPath)) {
+    this->folderOwners.remove(basePath);
+    this->folderOwners.save(this->getFolderOwnersPath());
+    return;
+  }
 
-        // No need to do anything if the picked mod is also the currently-active one:
-        if (activeMod == mod) { return; }
+  // The list exists, so this only opens it:
+  FsManager::ManifestWriter ownerList(ownerListPath);
 
-        // If there's an active mod, deactivate it:
-        if (!activeMod.empty()) {
-          this->returnFiles(activeMod);
-        }
+  // Record each entry in the folder individually. Sub-folders still only belong to the owner, so they stay whole:
+  FsManager::DirStream dir(folderPath, FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles);
 
-        this->activateMod(mod);
-        return;
-      }
+  while (FsDirectoryEntry* entry = dir.next()) {
+    FsPath entryPath = FsPath(basePath).join(entry->name);
 
-      randomChoice -= rating;
+    bool isFolder = entry->type == FsDirEntryType_Dir;
+    if (isFolder) {
+      this->folderOwners.add(entryPath.view(), owner.group, owner.source, owner.mod);
     }
+
+    ownerList.add(entryPath.view(), isFolder);
+
+    // The folder's contents weren't indexed while it was whole:
+    this->atmosphereIndex.add(entryPath.view(), isFolder);
   }
-}
 
-/**
- * Unmount SD card when destroyed 
- */
-Controller::~Controller() {
-  fsFsClose(&FsManager::sdSystem);
+  ownerList.flush();
+
+  // Once everything is recorded, the folder is no longer moved back as a whole:
+  this->folderOwners.remove(basePath);
+  this->folderOwners.save(this->getFolderOwnersPath());
 }
 
 /**
- * Returns all files belonging to a mod from the atmosphere active mods folder to their original location
- * 
- * Essentially the same as deactivating the mod, except this can't be used with the default mod option.
+ * Reads the catalog of the game's folder, building it from scratch if it's missing (or updating it if it's out of date)
  */
-void Controller::returnFiles(const std::string& mod) {
-
-  std::unique_ptr<char[]> movedFilesListPath = FsManager::toPathBuffer(this->getMovedFilesListFilePath(mod));
-  std::string modPath = this->getModPath(mod);
-
-  // Try to open the active mod's txt file to get the list of files that were moved to atmosphere's folder:
-  FsFile movedFilesList;
-  GuiError::tryResult(
-    fsFsOpenFile(&FsManager::sdSystem, movedFilesListPath.get(), FsOpenMode_Read, &movedFilesList),
-    "fsReadMoved"
-  );
-
-  s64 fileSize;
-  GuiError::tryResult(
-    fsFileGetSize(&movedFilesList, &fileSize),
-    "fsMovedSize"
-  );
-
-  // Initialize buffer and path builder:
-  s64 offset = 0;
-  char* buffer = new char[FILE_LIST_BUFFER_SIZE];
-  std::string pathBuilder = "";
-
-  // As long as there is still data in the file:
-  while (offset < fileSize) {
-
-    // Read some of the text into our buffer:
-    GuiError::tryResult(
-      fsFileRead(&movedFilesList, offset, buffer, FILE_LIST_BUFFER_SIZE, FsReadOption_None, nullptr),
-      "fsReadPath"
-    );
-
-    // Append it to the string we're using to build the next path:
-    pathBuilder += std::string_view(buffer, FILE_LIST_BUFFER_SIZE);
-
-    // If the path builder got a new line character from the buffer, we have a full path:
-    std::size_t newLinePos = pathBuilder.find('\n');
-    if (newLinePos != std::string::npos) {
-      // Trim the new line and any characters that were gathered after it to get the cleaned atmosphere file path:
-      std::string basePath = pathBuilder.substr(0, newLinePos);
-
-      // Move any characters gathered after the new line to the pathBuilder string for the next path:
-      pathBuilder = pathBuilder.substr(newLinePos + 1);
-
-      // Move the file back to the mod's folder:
-      FsManager::moveFile(
-        this->getAtmospherePath() + basePath,
-        modPath + basePath
-      );
-
-      // Not sure why, but the file needs to be re-opened after each time a file moved:
-      fsFileClose(&movedFilesList);
-      GuiError::tryResult(
-        fsFsOpenFile(&FsManager::sdSystem, movedFilesListPath.get(), FsOpenMode_Read, &movedFilesList),
-        "fsReadMoved"
-      );
+void Controller::loadCatalog() {
+  FsPath catalogPath = this->getCatalogPath();
+  bool loaded = this->catalog.load(catalogPath);
+
+  // The active mods can be found from the lists of moved files alone, without cataloging everything again:
+  if (loaded && !this->catalog.loadActiveMods(this->getActiveModsPath())) {
+    this->catalog.findActiveMods(this->gamePath);
+    this->catalog.saveActiveMods(this->getActiveModsPath());
+  }
+
+  bool timesUpdated = false;
+  if (!loaded || !this->catalog.isCurrent(this->gamePath, timesUpdated)) {
+    // Only mods that weren't cataloged before need their files counted:
+    if (loaded) {
+      this->catalog.update(this->gamePath);
+    } else {
+      this->catalog.build(this->gamePath);
     }
 
-    offset += FILE_LIST_BUFFER_SIZE;
+    this->catalog.save(catalogPath);
+    this->catalog.saveActiveMods(this->getActiveModsPath());
+  } else if (timesUpdated) {
+    this->catalog.save(catalogPath);
   }
 
-  delete[] buffer;
+  // Ratings & locks changed in the overlay take the place of what the folders' names say:
+  this->catalog.loadMetadata(this->getMetadataPath());
+}
 
-  fsFileClose(&movedFilesList);
+/**
+ * Writes out the active mods after they've changed (unless they're being held until a batch of changes is done)
+ */
+void Controller::saveActiveMods() {
+  if (!this->holdActiveMods) {
+    this->catalog.saveActiveMods(this->getActiveModsPath());
+  }
+}
 
-  // Once all the files have been returned, delete the txt list:
-  GuiError::tryResult(
-    fsFsDeleteFile(&FsManager::sdSystem, movedFilesListPath.get()),
-    "deleteMovedFile"
-  );
+/**
+ * Locks/unlocks a source in the current group
+ */
+void Controller::setSourceLocked(u32 source, bool locked) {
+  this->catalog.setSourceLocked(source, locked);
+  this->catalog.saveMetadata(this->getMetadataPath());
 }
 
 /*
  * Gets Mod Alchemist's game directory:
  */
-std::string Controller::getGamePath() {
-  return ALCHEMIST_PATH + MetaManager::getHexTitleId(this->titleId);
+const FsPath& Controller::getGamePath() {
+  return this->gamePath;
 }
 
 /*
@@ -605,8 +722,8 @@ std::string Controller::getGamePath() {
  * 
  * @requirement: group must be set
  */
-std::string Controller::getGroupPath() {
-  return this->getGamePath() + "/" + this->group;
+FsPath Controller::getGroupPath() {
+  return FsPath(this->gamePath).join(this->catalog.groupName(this->group));
 }
 
 /*
@@ -614,9 +731,8 @@ std::string Controller::getGroupPath() {
  * 
  * @requirement: group and source must be set
  */
-std::string Controller::getSourcePath() {
-  std::string groupPath = this->getGroupPath();
-  return groupPath + "/" + FsManager::getFolderName(groupPath, this->source);
+FsPath Controller::getSourcePath() {
+  return this->getGroupPath().join(this->catalog.sourceFolderName(this->source));
 }
 
 /*
@@ -624,16 +740,57 @@ std::string Controller::getSourcePath() {
  * 
  * @requirement: group and source must be set
  */
-std::string Controller::getModPath(const std::string& mod) {
-  std::string sourcePath = this->getSourcePath();
-  return sourcePath + "/" + FsManager::getFolderName(sourcePath, mod);
+FsPath Controller::getModPath(u32 mod) {
+  return this->getSourcePath().join(this->catalog.modFolderName(mod));
+}
+
+/**
+ * Gets the file path for the catalog of the game's folder
+ */
+FsPath Controller::getCatalogPath() {
+  return FsPath(this->gamePath).join(CATALOG_NAME);
+}
+
+/**
+ * Gets the file path for the ratings & locks changed in the overlay
+ */
+FsPath Controller::getMetadataPath() {
+  return FsPath(this->gamePath).join(METADATA_NAME);
+}
+
+/**
+ * Gets the file path for the active mod of each source in the catalog
+ */
+FsPath Controller::getActiveModsPath() {
+  return FsPath(this->gamePath).join(ACTIVE_MODS_NAME);
+}
+
+/**
+ * Gets the file path for the journal of the activation/return in progress
+ */
+FsPath Controller::getJournalPath() {
+  return FsPath(this->gamePath).join(JOURNAL_NAME);
+}
+
+/**
+ * Gets the file path for the game's saved profiles
+ */
+FsPath Controller::getProfilesPath() {
+  return FsPath(this->gamePath).join(PROFILES_NAME);
+}
+
+/**
+ * Gets the file path for the owners of folders moved into Atmosphere's folder as a whole
+ */
+FsPath Controller::getFolderOwnersPath() {
+  return FsPath(this->gamePath).join(FOLDER_OWNERS_NAME);
 }
 
 /**
  * Gets the game's path that's stored within Atmosphere's directory
  */
-std::string Controller::getAtmospherePath() {
-  return ATMOSPHERE_PATH + MetaManager::getHexTitleId(this->titleId);
+const FsPath& Controller::getAtmospherePath() {
+  return this->atmospherePath;
 }
 
 /**
@@ -643,6 +800,17 @@ std::string Controller::getAtmospherePath() {
  * 
  * @requirement: group and source must be set
  */
-std::string Controller::getMovedFilesListFilePath(const std::string& mod) {
-  return this->getSourcePath() + "/" + mod + TXT_EXT;
+FsPath Controller::getMovedFilesListFilePath(u32 mod) {
+  // Which format the list is in was found when the catalog was built, so nothing needs to be checked here:
+  bool legacy = this->catalog.activeMod(this->source) == mod && this->catalog.hasLegacyList(this->source);
+  return this->getMovedFilesListFilePath(this->getSourcePath(), this->catalog.modName(mod), legacy);
+}
+
+/**
+ * Gets the file path for the list of moved files for a mod within the specified source folder
+ * 
+ * @param legacy If the mod was activated by an older version, which used a txt list (see `Catalog::hasLegacyList()`)
+ */
+FsPath Controller::getMovedFilesListFilePath(const FsPath& sourcePath, std::string_view mod, bool legacy) {
+  return FsPath(sourcePath).join(mod).append(legacy ? TXT_EXT : MANIFEST_EXT);
 }
@@ -0,0 +1,272 @@
+#include "diagnostics.h"
+
+#ifdef ALCHEMIST_DIAGNOSTICS
+
+#include "fs_manager.h"
+
+#include <malloc.h>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Kept before each allocation, so delete knows how many bytes it's freeing
+// (16 bytes to keep allocations aligned the same as malloc's):
+static const std::size_t HEADER_SIZE = 16;
+
+static std::atomic<u64> allocationCount = 0;
+static std::atomic<u64> allocatedBytes = 0;
+static std::atomic<u64> liveBytes = 0;
+static std::atomic<u64> peakLiveBytes = 0;
+
+// The most bytes allocated at once for each running scope (one bit in the mask for each slot in use):
+static std::atomic<u64> scopePeaks[Diagnostics::MAX_ACTIVE_SCOPES];
+static std::atomic<u32> activeScopes = 0;
+
+// The screen that's open (only changed from the UI thread):
+static Diagnostics::ScreenScope* currentScreen = nullptr;
+
+static Diagnostics::Record records[Diagnostics::MAX_RECORDS];
+static u32 recordCount = 0;
+static Mutex recordsMutex;
+
+/**
+ * Raises the value to at least the new value
+ */
+static void raise(std::atomic<u64>& value, u64 newValue) {
+  u64 current = value;
+  while (current < newValue && !value.compare_exchange_weak(current, newValue)) {}
+}
+
+static void* allocate(std::size_t size) {
+  void* block = std::malloc(size + HEADER_SIZE);
+  if (block == nullptr) { return nullptr; }
+
+  *static_cast<std::size_t*>(block) = size;
+
+  allocationCount++;
+  allocatedBytes += size;
+  u64 live = liveBytes += size;
+
+  raise(peakLiveBytes, live);
+  u32 active = activeScopes;
+  for (u32 slot = 0; slot < Diagnostics::MAX_ACTIVE_SCOPES; slot++) {
+    if (active & (1 << slot)) {
+      raise(scopePeaks[slot], live);
+    }
+  }
+
+  return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+static void release(void* pointer) {
+  if (pointer == nullptr) { return; }
+
+  void* block = static_cast<char*>(pointer) - HEADER_SIZE;
+  liveBytes -= *static_cast<std::size_t*>(block);
+  std::free(block);
+}
+
+void* operator new(std::size_t size) {
+  void* pointer = allocate(size);
+  if (pointer == nullptr) { abort(); }
+  return pointer;
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  release(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  release(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  release(pointer);
+}
+
+Diagnostics::Scope::Scope(const char* name) : name(name), slot(-1) {
+  this->startAllocations = allocationCount;
+  this->startAllocatedBytes = allocatedBytes;
+  this->startLiveBytes = liveBytes;
+
+  // Claim a free slot for tracking the peak:
+  u32 active = activeScopes;
+  for (u32 slot = 0; slot < MAX_ACTIVE_SCOPES && this->slot == -1;) {
+    if (active & (1 << slot)) {
+      slot++;
+      continue;
+    }
+
+    scopePeaks[slot] = this->startLiveBytes;
+    if (activeScopes.compare_exchange_weak(active, active | (1 << slot))) {
+      this->slot = slot;
+    }
+    // Otherwise, another scope changed the slots in use first, so the same slot is checked again
+  }
+}
+
+Diagnostics::Scope::~Scope() {
+  u64 peak = liveBytes;
+  if (this->slot != -1) {
+    peak = scopePeaks[this->slot];
+    activeScopes &= ~(1 << this->slot);
+  }
+
+  u64 heap = getHeapBytes();
+
+  mutexLock(&recordsMutex);
+
+  Record* record = nullptr;
+  for (u32 i = 0; i < recordCount; i++) {
+    if (std::strcmp(records[i].name, this->name) == 0) {
+      record = &records[i];
+      break;
+    }
+  }
+  if (record == nullptr && recordCount < MAX_RECORDS) {
+    record = &records[recordCount++];
+    *record = { this->name, 0, 0, 0, 0, 0, 0 };
+  }
+
+  if (record != nullptr) {
+    record->runs++;
+    record->allocations += allocationCount - this->startAllocations;
+    record->allocatedBytes += allocatedBytes - this->startAllocatedBytes;
+    record->retainedBytes = (s64) liveBytes - (s64) this->startLiveBytes;
+    if (peak > record->peakLiveBytes) { record->peakLiveBytes = peak; }
+    if (heap > record->peakHeapBytes) { record->peakHeapBytes = heap; }
+  }
+
+  mutexUnlock(&recordsMutex);
+}
+
+/**
+ * Allocations made since the scope started (not counting what was left out with `exclude()`)
+ */
+u64 Diagnostics::Scope::getAllocations() const {
+  return allocationCount - this->startAllocations;
+}
+
+u64 Diagnostics::Scope::getAllocatedBytes() const {
+  return allocatedBytes - this->startAllocatedBytes;
+}
+
+/**
+ * Leaves allocations recorded by another scope (such as a screen opened from this one) out of this one's totals
+ */
+void Diagnostics::Scope::exclude(u64 allocations, u64 bytes) {
+  this->startAllocations += allocations;
+  this->startAllocatedBytes += bytes;
+}
+
+Diagnostics::ScreenScope::ScreenScope(const char* name) : Scope(name), parent(currentScreen) {
+  currentScreen = this;
+}
+
+Diagnostics::ScreenScope::~ScreenScope() {
+  currentScreen = this->parent;
+
+  // The screen this was opened from only counts what it allocated itself:
+  if (this->parent != nullptr) {
+    this->parent->exclude(this->getAllocations(), this->getAllocatedBytes());
+  }
+}
+
+/**
+ * Bytes currently allocated through new/delete, and the most there have ever been at once
+ */
+u64 Diagnostics::getLiveBytes() {
+  return liveBytes;
+}
+
+u64 Diagnostics::getPeakLiveBytes() {
+  return peakLiveBytes;
+}
+
+/**
+ * Bytes of the heap in use according to malloc (including what's allocated outside of new/delete)
+ */
+u64 Diagnostics::getHeapBytes() {
+  return mallinfo().uordblks;
+}
+
+/**
+ * Memory used by the whole overlay process, and how much it's allowed
+ */
+u64 Diagnostics::getProcessBytes() {
+  u64 used = 0;
+  svcGetInfo(&used, InfoType_UsedMemorySize, CUR_PROCESS_HANDLE, 0);
+  return used;
+}
+
+u64 Diagnostics::getProcessLimit() {
+  u64 total = 0;
+  svcGetInfo(&total, InfoType_TotalMemorySize, CUR_PROCESS_HANDLE, 0);
+  return total;
+}
+
+u32 Diagnostics::getRecordCount() {
+  return recordCount;
+}
+
+const Diagnostics::Record& Diagnostics::getRecord(u32 index) {
+  return records[index];
+}
+
+/**
+ * Formats everything recorded as text, one line per record
+ */
+std::string Diagnostics::report() {
+  std::string text;
+  text += "live " + std::to_string(getLiveBytes()) + " peak " + std::to_string(getPeakLiveBytes());
+  text += " heap " + std::to_string(getHeapBytes());
+  text += " process " + std::to_string(getProcessBytes()) + "/" + std::to_string(getProcessLimit()) + "\n";
+
+  mutexLock(&recordsMutex);
+  for (u32 i = 0; i < recordCount; i++) {
+    const Record& record = records[i];
+    text += std::string(record.name);
+    text += " runs " + std::to_string(record.runs);
+    text += " allocs " + std::to_string(record.allocations);
+    text += " bytes " + std::to_string(record.allocatedBytes);
+    text += " retained " + std::to_string(record.retainedBytes);
+    text += " peak " + std::to_string(record.peakLiveBytes);
+    text += " heap " + std::to_string(record.peakHeapBytes) + "\n";
+  }
+  mutexUnlock(&recordsMutex);
+
+  return text;
+}
+
+/**
+ * Writes the report to a file
+ */
+void Diagnostics::dump(const FsPath& path) {
+  FsManager::writeFile(path, report());
+}
+
+#endif // ALCHEMIST_DIAGNOSTICS
@@ -0,0 +1,74 @@
+#include "folder_owners.h"
+
+#include "fs_manager.h"
+
+/**
+ * Reads the owners from the file (leaving none if there's no file)
+ */
+void FolderOwners::load(const FsPath& path) {
+  this->owners.clear();
+  this->changed = false;
+
+  FsManager::finishReplacingFile(path);
+  if (!FsManager::doesFileExist(path)) { return; }
+
+  std::string contents = FsManager::readFile(path);
+  std::string_view data(contents);
+
+  // Each record is 4 lines: the folder, then its owner's group, source & mod (a record that was cut off is skipped):
+  std::string_view lines[4];
+  while (!data.empty()) {
+    for (std::string_view& line : lines) {
+      std::size_t lineEnd = data.find('\n');
+      if (lineEnd == std::string_view::npos) { return; }
+
+      line = data.substr(0, lineEnd);
+      data.remove_prefix(lineEnd + 1);
+    }
+
+    this->owners.insert_or_assign(std::string(lines[0]), Owner{ std::string(lines[1]), std::string(lines[2]), std::string(lines[3]) });
+  }
+}
+
+/**
+ * Writes out the owners if they've changed since they were last loaded or saved
+ */
+void FolderOwners::save(const FsPath& path) {
+  if (!this->changed) { return; }
+
+  std::string data;
+  for (const auto& [folder, owner] : this->owners) {
+    data.append(folder).append("\n");
+    data.append(owner.group).append("\n");
+    data.append(owner.source).append("\n");
+    data.append(owner.mod).append("\n");
+  }
+
+  FsManager::replaceFile(path, data);
+  this->changed = false;
+}
+
+/**
+ * Gets the owner of the folder (nullptr if the folder wasn't moved as a whole)
+ */
+const FolderOwners::Owner* FolderOwners::find(std::string_view folder) const {
+  auto found = this->owners.find(folder);
+  return found == this->owners.end() ? nullptr : &found->second;
+}
+
+bool FolderOwners::contains(std::string_view folder) const {
+  return this->owners.find(folder) != this->owners.end();
+}
+
+void FolderOwners::add(std::string_view folder, std::string_view group, std::string_view source, std::string_view mod) {
+  this->owners.insert_or_assign(std::string(folder), Owner{ std::string(group), std::string(source), std::string(mod) });
+  this->changed = true;
+}
+
+void FolderOwners::remove(std::string_view folder) {
+  auto found = this->owners.find(folder);
+  if (found == this->owners.end()) { return; }
+
+  this->owners.erase(found);
+  this->changed = true;
+}
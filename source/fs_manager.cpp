@@ -2,45 +2,453 @@
 #include "meta_manager.h"
 #include "ui/ui_error.h"
 
+#include <algorithm>
+#include <cstring>
+
 FsFileSystem FsManager::sdSystem;
 
+FsManager::DirStream::DirStream(const FsPath& path, const u32& mode, const s64& batchSize)
+  : mode(mode), batchSize(batchSize), entries(new FsDirectoryEntry[batchSize]), readCount(0), readIndex(0), finished(false) {
+  GuiError::tryResult(
+    fsFsOpenDirectory(&sdSystem, path.c_str(), mode, &this->dir),
+    "fsOpenDir"
+  );
+}
+
+FsManager::DirStream::~DirStream() {
+  fsDirClose(&this->dir);
+}
+
 /**
- * Creates a new open FsDir object for the specified path
+ * Gets the next entry in the folder
  * 
- * Don't forget to close when done
+ * Returns nullptr once every entry has been read.
+ * The entry is only valid until the next call.
  */
-FsDir FsManager::openFolder(const std::string& path, const u32& mode) {
-  FsDir dir;
-  changeFolder(dir, path, mode);
-  return dir;
+FsDirectoryEntry* FsManager::DirStream::next() {
+  while (!this->finished) {
+
+    // Refill the buffer once everything in it has been handed out:
+    if (this->readIndex >= this->readCount) {
+      this->readIndex = 0;
+      Result result = fsDirRead(&this->dir, &this->readCount, this->batchSize, this->entries.get());
+
+      if (R_FAILED(result) || this->readCount == 0) {
+        this->readCount = 0;
+        this->finished = true;
+        break;
+      }
+    }
+
+    FsDirectoryEntry* entry = &this->entries[this->readIndex++];
+
+    // Skip any entry of a type that wasn't asked for:
+    bool wanted = entry->type == FsDirEntryType_Dir
+      ? this->mode & FsDirOpenMode_ReadDirs
+      : this->mode & FsDirOpenMode_ReadFiles;
+
+    if (wanted) { return entry; }
+  }
+
+  return nullptr;
+}
+
+FsManager::TreeWalker::TreeWalker(const FsPath& root)
+  : currentPath(root), rootLength(root.length()), hasEntry(false) {
+  this->streams.push_back(
+    std::make_unique<DirStream>(root, FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles, TREE_WALK_BATCH_SIZE)
+  );
+}
+
+/**
+ * Moves on to the next entry in the tree
+ * 
+ * Returns nullptr once every entry has been visited.
+ * The entry is only valid until the next call.
+ */
+FsDirectoryEntry* FsManager::TreeWalker::next() {
+  if (this->hasEntry) {
+    this->currentPath.popSegment();
+    this->hasEntry = false;
+  }
+
+  while (!this->streams.empty()) {
+    FsDirectoryEntry* entry = this->streams.back()->next();
+
+    if (entry) {
+      this->currentPath.join(entry->name);
+      this->hasEntry = true;
+      return entry;
+    }
+
+    // The current folder is done, so close it and carry on where we left off in its parent:
+    this->streams.pop_back();
+    if (!this->streams.empty()) {
+      this->currentPath.popSegment();
+    }
+  }
+
+  return nullptr;
+}
+
+/**
+ * Walks into the folder last returned by `next()`, so its entries are the next ones visited
+ */
+void FsManager::TreeWalker::enter() {
+  this->streams.push_back(
+    std::make_unique<DirStream>(this->currentPath, FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles, TREE_WALK_BATCH_SIZE)
+  );
+
+  // The folder's name now stays in the path until all of its entries have been visited:
+  this->hasEntry = false;
+}
+
+/**
+ * Full path of the entry last returned by `next()`
+ */
+const FsPath& FsManager::TreeWalker::path() const {
+  return this->currentPath;
+}
+
+/**
+ * Path of the entry last returned by `next()` relative to the root (starting with a '/')
+ */
+std::string_view FsManager::TreeWalker::relativePath() const {
+  return this->currentPath.view().substr(this->rootLength);
+}
+
+FsManager::BlockWriter::BlockWriter(const FsPath& path, const s64& blockSize)
+  : file(initFile(path)), blockSize(blockSize), buffer(new char[blockSize]), used(0) {
+  GuiError::tryResult(fsFileGetSize(&this->file, &this->offset), "fsWriterSize");
+}
+
+FsManager::BlockWriter::~BlockWriter() {
+  fsFileClose(&this->file);
+}
+
+/**
+ * Checks if the specified number of bytes fits in what's left of the buffer
+ */
+bool FsManager::BlockWriter::fits(const s64& size) const {
+  return this->used + size <= this->blockSize;
+}
+
+/**
+ * Checks if nothing has ever been written to the file
+ */
+bool FsManager::BlockWriter::isEmpty() const {
+  return this->offset == 0 && this->used == 0;
+}
+
+/**
+ * Adds the text to the buffer, writing out the buffer first if it's full
+ */
+void FsManager::BlockWriter::append(std::string_view text) {
+  if (!this->fits(text.size())) {
+    this->flush();
+  }
+
+  // Text larger than a whole block is written directly:
+  if (!this->fits(text.size())) {
+    write(this->file, text, this->offset);
+    return;
+  }
+
+  std::memcpy(this->buffer.get() + this->used, text.data(), text.size());
+  this->used += text.size();
 }
 
 /**
- * Changes an FsDir instance to the specified path
+ * Writes & flushes everything buffered to the file
+ * 
+ * Returns the text that was written, which stays valid until the next `append()`
  */
-void FsManager::changeFolder(FsDir& dir, const std::string& path, const u32& mode) {
-  fsDirClose(&dir);
+std::string_view FsManager::BlockWriter::flush() {
+  std::string_view written(this->buffer.get(), this->used);
+
+  if (this->used > 0) {
+    write(this->file, written, this->offset);
+    this->used = 0;
+  }
+
+  return written;
+}
 
+FsManager::FileReader::FileReader(const FsPath& path, const s64& bufferSize) : offset(0), start(0), end(0) {
   GuiError::tryResult(
-    fsFsOpenDirectory(&sdSystem, toPathBuffer(path).get(), mode, &dir),
-    "fsOpenDir"
+    fsFsOpenFile(&sdSystem, path.c_str(), FsOpenMode_Read, &this->file),
+    "fsOpenReader"
   );
+  GuiError::tryResult(fsFileGetSize(&this->file, &this->fileSize), "fsReaderSize");
+
+  // No need for a buffer larger than the file itself:
+  this->bufferSize = std::max<s64>(std::min(bufferSize, this->fileSize), 1);
+  this->buffer.reset(new char[this->bufferSize]);
+}
+
+FsManager::FileReader::~FileReader() {
+  fsFileClose(&this->file);
+}
+
+/**
+ * Gets the next line (without its '\n')
+ * 
+ * Returns false once every line has been read.
+ * The line is only valid until the next call.
+ */
+bool FsManager::FileReader::nextLine(std::string_view& line) {
+  while (true) {
+    std::string_view unread(this->buffer.get() + this->start, this->end - this->start);
+
+    std::size_t newLinePos = unread.find('\n');
+    if (newLinePos != std::string_view::npos) {
+      line = unread.substr(0, newLinePos);
+      this->start += newLinePos + 1;
+      return true;
+    }
+
+    // At the end of the file, whatever is left is the last line:
+    if (!this->refill()) {
+      line = unread;
+      this->start = this->end;
+      return !line.empty();
+    }
+  }
+}
+
+/**
+ * Gets up to the specified number of bytes from the current position without moving past them
+ * (fewer are returned only at the end of the file)
+ * 
+ * The bytes are only valid until the next call.
+ */
+std::string_view FsManager::FileReader::peek(const s64& size) {
+  while (this->end - this->start < size && this->refill()) {}
+
+  return std::string_view(this->buffer.get() + this->start, std::min(size, this->end - this->start));
+}
+
+/**
+ * Moves past bytes that were peeked
+ */
+void FsManager::FileReader::skip(const s64& size) {
+  this->start = std::min(this->start + size, this->end);
+}
+
+/**
+ * Moves the unread part of the buffer to the front, and fills the rest with the next chunk of the file
+ * 
+ * Returns false if there was nothing left to read
+ */
+bool FsManager::FileReader::refill() {
+  if (this->offset >= this->fileSize) { return false; }
+
+  std::memmove(this->buffer.get(), this->buffer.get() + this->start, this->end - this->start);
+  this->end -= this->start;
+  this->start = 0;
+
+  // The buffer is full of data that hasn't been handed out yet:
+  if (this->end == this->bufferSize) { return false; }
+
+  u64 bytesRead = 0;
+  GuiError::tryResult(
+    fsFileRead(&this->file, this->offset, this->buffer.get() + this->end, this->bufferSize - this->end, FsReadOption_None, &bytesRead),
+    "fsReadChunk"
+  );
+
+  // Treat a short read as the end of the file:
+  if (bytesRead == 0) {
+    this->fileSize = this->offset;
+    return false;
+  }
+
+  this->offset += bytesRead;
+  this->end += bytesRead;
+  return true;
+}
+
+/**
+ * Decodes a record of a path in the binary list of moved files (see MANIFEST_MAGIC),
+ * applying it to the previous path
+ * 
+ * @param record Must contain at least the record's header
+ * @return Size of the whole record (which may be more than what's in the record parameter)
+ */
+static s64 decodeManifestRecord(std::string_view record, FsPath& path, bool& isFolder) {
+  const u8* header = reinterpret_cast<const u8*>(record.data());
+
+  isFolder = header[0] & MANIFEST_FOLDER_FLAG;
+  u16 sharedLength = header[1] | (header[2] << 8);
+  u16 suffixLength = header[3] | (header[4] << 8);
+
+  s64 recordSize = MANIFEST_RECORD_HEADER_SIZE + suffixLength;
+
+  if (sharedLength > path.length() || (s64) record.size() < recordSize) {
+    GuiError::fail("List of moved files is corrupt");
+  }
+
+  path.truncate(sharedLength);
+  path.append(record.substr(MANIFEST_RECORD_HEADER_SIZE, suffixLength));
+
+  return recordSize;
+}
+
+/**
+ * Checks if a list of moved files already exists in the legacy text format
+ */
+static bool isLegacyManifest(const FsPath& path) {
+  if (!FsManager::doesFileExist(path)) { return false; }
+
+  FsManager::FileReader reader(path);
+  std::string_view start = reader.peek(MANIFEST_MAGIC.size());
+  return !start.empty() && start != MANIFEST_MAGIC;
 }
 
-void FsManager::createFolderIfNeeded(const std::string& path) {
+FsManager::ManifestWriter::ManifestWriter(const FsPath& path)
+  : legacy(isLegacyManifest(path)), writer(path) {
+
+  // New lists start with the header for the binary format
+  // (existing lists are appended to in whatever format they're already in):
+  if (this->writer.isEmpty()) {
+    this->writer.append(MANIFEST_MAGIC);
+    this->writer.append(std::string_view(reinterpret_cast<const char*>(&MANIFEST_VERSION), 1));
+    this->writer.flush();
+  }
+}
+
+/**
+ * Checks if a record for the path fits in what's left of the current block
+ */
+bool FsManager::ManifestWriter::fits(std::string_view path) const {
+  // Front-coding only makes the record smaller, and a legacy line is always smaller than the full record:
+  return this->writer.fits(MANIFEST_RECORD_HEADER_SIZE + path.size());
+}
+
+/**
+ * Records the path, writing out the current block first if it's full
+ */
+void FsManager::ManifestWriter::add(std::string_view path, bool isFolder) {
+  if (this->legacy) {
+    FsPath line(path);
+    line.append(isFolder ? "/\n" : "\n");
+    this->writer.append(line.view());
+    return;
+  }
+
+  // Find how much of the start of the path is the same as the last one:
+  std::string_view lastPath = this->lastPath.view();
+  std::size_t sharedLength = 0;
+  while (sharedLength < lastPath.size() && sharedLength < path.size() && lastPath[sharedLength] == path[sharedLength]) {
+    sharedLength++;
+  }
+  std::size_t suffixLength = path.size() - sharedLength;
+
+  // Build the whole record first, so it's never split between blocks:
+  char record[MANIFEST_RECORD_HEADER_SIZE + FS_MAX_PATH];
+  record[0] = isFolder ? MANIFEST_FOLDER_FLAG : 0;
+  record[1] = sharedLength & 0xFF;
+  record[2] = sharedLength >> 8;
+  record[3] = suffixLength & 0xFF;
+  record[4] = suffixLength >> 8;
+  std::memcpy(record + MANIFEST_RECORD_HEADER_SIZE, path.data() + sharedLength, suffixLength);
+
+  this->writer.append(std::string_view(record, MANIFEST_RECORD_HEADER_SIZE + suffixLength));
+  this->lastPath = FsPath(path);
+}
+
+/**
+ * Writes & flushes the current block to the file
+ * 
+ * Afterwards, `nextFlushed()` goes through the paths in the block that was written
+ */
+void FsManager::ManifestWriter::flush() {
+  this->flushed = this->writer.flush();
+}
+
+/**
+ * Gets the next path in the block written by the last `flush()`
+ * 
+ * Returns false once every path in it has been gone through.
+ * The path is only valid until the next call.
+ */
+bool FsManager::ManifestWriter::nextFlushed(std::string_view& path, bool& isFolder) {
+  if (this->flushed.empty()) { return false; }
+
+  if (this->legacy) {
+    std::size_t newLinePos = this->flushed.find('\n');
+    path = this->flushed.substr(0, newLinePos);
+    this->flushed.remove_prefix(newLinePos + 1);
+
+    isFolder = path.ends_with('/');
+    if (isFolder) {
+      path.remove_suffix(1);
+    }
+    return true;
+  }
+
+  // Records never span blocks, so the block is decoded where it is:
+  s64 recordSize = decodeManifestRecord(this->flushed, this->flushedPath, isFolder);
+  this->flushed.remove_prefix(recordSize);
+
+  path = this->flushedPath.view();
+  return true;
+}
+
+FsManager::ManifestReader::ManifestReader(const FsPath& path) : reader(path) {
+  this->legacy = this->reader.peek(MANIFEST_MAGIC.size()) != MANIFEST_MAGIC;
+
+  // Skip the magic & version:
+  if (!this->legacy) {
+    this->reader.skip(MANIFEST_MAGIC.size() + 1);
+  }
+}
+
+/**
+ * Gets the next path in the list
+ * 
+ * Returns false once every path has been read.
+ * The path is only valid until the next call.
+ */
+bool FsManager::ManifestReader::next(std::string_view& path, bool& isFolder) {
+  if (this->legacy) {
+    // Legacy lists have one path per line, with folders ending in '/':
+    do {
+      if (!this->reader.nextLine(path)) { return false; }
+    } while (path.empty());
+
+    isFolder = path.ends_with('/');
+    if (isFolder) {
+      path.remove_suffix(1);
+    }
+    return true;
+  }
+
+  std::string_view header = this->reader.peek(MANIFEST_RECORD_HEADER_SIZE);
+  if ((s64) header.size() < MANIFEST_RECORD_HEADER_SIZE) { return false; }
+
+  u16 suffixLength = (u8) header[3] | ((u8) header[4] << 8);
+  std::string_view record = this->reader.peek(MANIFEST_RECORD_HEADER_SIZE + suffixLength);
+
+  this->reader.skip(decodeManifestRecord(record, this->currentPath, isFolder));
+
+  path = this->currentPath.view();
+  return true;
+}
+
+void FsManager::createFolderIfNeeded(const FsPath& path) {
   if (doesFolderExist(path)) { return; }
 
   GuiError::tryResult(
-    fsFsCreateDirectory(&sdSystem, toPathBuffer(path).get()),
+    fsFsCreateDirectory(&sdSystem, path.c_str()),
     "fsCreateDir"
   );
 }
 
-bool FsManager::doesFolderExist(const std::string& path) {
+bool FsManager::doesFolderExist(const FsPath& path) {
   FsDir dir;
   Result result = fsFsOpenDirectory(
     &sdSystem,
-    toPathBuffer(path).get(),
+    path.c_str(),
     FsOpenMode_Read,
     &dir
   );
@@ -56,11 +464,11 @@ bool FsManager::doesFolderExist(const std::string& path) {
   }
 }
 
-bool FsManager::doesFileExist(const std::string& path) {
+bool FsManager::doesFileExist(const FsPath& path) {
   FsFile file;
   Result result = fsFsOpenFile(
     &sdSystem,
-    toPathBuffer(path).get(),
+    path.c_str(),
     FsOpenMode_Read,
     &file
   );
@@ -76,6 +484,21 @@ bool FsManager::doesFileExist(const std::string& path) {
   }
 }
 
+/**
+ * Gets when a file or folder was last modified, for telling if it has changed
+ *
+ * Returns false if the time can't be read (such as if there's nothing at the path)
+ */
+bool FsManager::getModifiedTime(const FsPath& path, u64& time) {
+  FsTimeStampRaw timeStamp;
+  if (R_FAILED(fsFsGetFileTimeStampRaw(&sdSystem, path.c_str(), &timeStamp)) || !timeStamp.is_valid) {
+    return false;
+  }
+
+  time = timeStamp.modified;
+  return true;
+}
+
 /**
  * Gets a vector of all entity names that are directly within the specified path
  * (parsing the name from the folder name)
@@ -83,21 +506,15 @@ bool FsManager::doesFileExist(const std::string& path) {
  * @param sort Whether to sort the list of names alphabetically or not
  *             Can take considerable performance when in nested loops, so sometimes it's good to skip if not needed
  */
-std::vector<std::string> FsManager::listNames(const std::string& path, bool sort) {
+std::vector<std::string> FsManager::listNames(const FsPath& path, bool sort) {
   std::vector<std::string> names;
 
-  FsDir dir = FsManager::openFolder(path, FsDirOpenMode_ReadDirs);
+  DirStream dir(path, FsDirOpenMode_ReadDirs);
 
-  FsDirectoryEntry entry;
-  s64 readCount = 0;
-  while (R_SUCCEEDED(fsDirRead(&dir, &readCount, 1, &entry)) && readCount) {
-    if (entry.type == FsDirEntryType_Dir) {
-      names.push_back(MetaManager::parseName(entry.name));
-    }
+  while (FsDirectoryEntry* entry = dir.next()) {
+    names.emplace_back(MetaManager::parseFolderName(entry->name).name);
   }
 
-  fsDirClose(&dir);
-
   if (sort) {
     std::sort(names.begin(), names.end());
   }
@@ -105,38 +522,14 @@ std::vector<std::string> FsManager::listNames(const std::string& path, bool sort
   return names;
 }
 
-/**
- * Gets the name of the folder that currently exists with the name of the specified entity
- */
-std::string FsManager::getFolderName(const std::string& path, const std::string& name) {
-  std::string folderName;
-  
-  FsDir dir = FsManager::openFolder(path, FsDirOpenMode_ReadDirs);
-
-  FsDirectoryEntry entry;
-  s64 readCount = 0;
-  while (R_SUCCEEDED(fsDirRead(&dir, &readCount, 1, &entry)) && readCount) {
-    if (entry.type == FsDirEntryType_Dir && MetaManager::namesMatch(entry.name, name)) {
-      folderName = entry.name;
-      break;
-    }
-  }
-
-  fsDirClose(&dir);
-
-  return folderName;
-}
-
 /**
  * Opens a file at the path (creating it if it doesn't exist)
  */
-FsFile FsManager::initFile(const std::string& path) {
-  std::unique_ptr<char[]> charPath = toPathBuffer(path);
-
+FsFile FsManager::initFile(const FsPath& path) {
   // If the file hasn't been created yet, create it:
   if (!doesFileExist(path)) {
     GuiError::tryResult(
-      fsFsCreateFile(&sdSystem, charPath.get(), 0, 0),
+      fsFsCreateFile(&sdSystem, path.c_str(), 0, 0),
       "fsCreateMoved"
     );
   }
@@ -144,24 +537,113 @@ FsFile FsManager::initFile(const std::string& path) {
   // Open the file:
   FsFile file;
   GuiError::tryResult(
-    fsFsOpenFile( &sdSystem, charPath.get(), FsOpenMode_Write | FsOpenMode_Append, &file),
+    fsFsOpenFile( &sdSystem, path.c_str(), FsOpenMode_Write | FsOpenMode_Append, &file),
     "fsWriteMoved"
   );
 
   return file;
 }
 
+/**
+ * Reads the entire contents of a (small) file
+ */
+std::string FsManager::readFile(const FsPath& path) {
+  FsFile file;
+  GuiError::tryResult(
+    fsFsOpenFile(&sdSystem, path.c_str(), FsOpenMode_Read, &file),
+    "fsOpenRead"
+  );
+
+  s64 fileSize;
+  GuiError::tryResult(fsFileGetSize(&file, &fileSize), "fsReadSize");
+
+  std::string text(fileSize, '\0');
+  u64 bytesRead = 0;
+  GuiError::tryResult(
+    fsFileRead(&file, 0, text.data(), fileSize, FsReadOption_None, &bytesRead),
+    "fsReadText"
+  );
+  text.resize(bytesRead);
+
+  fsFileClose(&file);
+
+  return text;
+}
+
+/**
+ * Replaces the contents of the file at the path with the text (creating the file if it doesn't exist)
+ */
+void FsManager::writeFile(const FsPath& path, std::string_view text) {
+  FsFile file = initFile(path);
+
+  GuiError::tryResult(fsFileSetSize(&file, text.size()), "fsSetSize");
+
+  s64 offset = 0;
+  write(file, text, offset);
+
+  fsFileClose(&file);
+}
+
+/**
+ * Replaces the contents of the file at the path with the text, so the file has either all of its old contents or all of its new ones
+ * 
+ * The text is written to a temporary file first (see REPLACEMENT_EXT), which then takes the file's place.
+ */
+void FsManager::replaceFile(const FsPath& path, std::string_view text) {
+  FsPath replacementPath = FsPath(path).append(REPLACEMENT_EXT);
+
+  writeFile(replacementPath, text);
+
+  // Renaming can't replace a file, so the old one is deleted first.
+  // If this is interrupted in between, finishReplacingFile() does the rename later:
+  deleteFileIfExists(path);
+  moveFile(replacementPath, path);
+}
+
+/**
+ * Finishes a `replaceFile()` that was interrupted after the old file was deleted
+ * 
+ * Call before reading a file that's written with `replaceFile()`
+ */
+void FsManager::finishReplacingFile(const FsPath& path) {
+  FsPath replacementPath = FsPath(path).append(REPLACEMENT_EXT);
+
+  // A replacement is only complete once the old file is gone. Otherwise, it may have been cut off while being written:
+  if (doesFileExist(path)) {
+    deleteFileIfExists(replacementPath);
+  } else {
+    moveFileIfExists(replacementPath, path);
+  }
+}
+
+void FsManager::deleteFile(const FsPath& path) {
+  GuiError::tryResult(
+    fsFsDeleteFile(&sdSystem, path.c_str()),
+    "fsDeleteFile"
+  );
+}
+
+/**
+ * Deletes the file if there is one at the path
+ */
+void FsManager::deleteFileIfExists(const FsPath& path) {
+  Result result = fsFsDeleteFile(&sdSystem, path.c_str());
+  if (result != 0x202) {
+    GuiError::tryResult(result, "fsDeleteFile");
+  }
+}
+
 /**
  * Records the text parameter in the filePath, appending it to the FsFile
  * 
  * offset is expected to be at the end of the file,
  * and it's updated to the new position at the end of file
  */
-void FsManager::write(FsFile& file, const std::string& text, s64& offset) {
+void FsManager::write(FsFile& file, std::string_view text, s64& offset) {
 
   // Write the path to the end of the list:
   GuiError::tryResult(
-    fsFileWrite(&file, offset, text.c_str(), text.size(), FsWriteOption_Flush),
+    fsFileWrite(&file, offset, text.data(), text.size(), FsWriteOption_Flush),
     "fsWritePath"
   );
 
@@ -172,30 +654,51 @@ void FsManager::write(FsFile& file, const std::string& text, s64& offset) {
 /**
  * Changes the fromPath file parameter's location to what's specified as the toPath parameter
  */
-void FsManager::moveFile(const std::string& fromPath, const std::string& toPath) {
+void FsManager::moveFile(const FsPath& fromPath, const FsPath& toPath) {
   GuiError::tryResult(
-    fsFsRenameFile(&sdSystem, toPathBuffer(fromPath).get(), toPathBuffer(toPath).get()),
+    fsFsRenameFile(&sdSystem, fromPath.c_str(), toPath.c_str()),
     "fsMoveFile"
   );
 }
 
 /**
- * Formats a string as a char array that will work properly as a parameter for libnx's filesystem functions
+ * Changes the fromPath folder's location (along with everything in it) to what's specified as the toPath parameter
+ */
+void FsManager::moveFolder(const FsPath& fromPath, const FsPath& toPath) {
+  GuiError::tryResult(
+    fsFsRenameDirectory(&sdSystem, fromPath.c_str(), toPath.c_str()),
+    "fsMoveFolder"
+  );
+}
+
+/**
+ * Same as `moveFile()`, except nothing happens if there's nothing at the fromPath
  * 
- * Use `get()` when passing it to a libnx function
+ * Returns whether anything was moved.
+ * Anything else that stops the move (such as the toPath's folder being missing) is still an error.
  */
-std::unique_ptr<char[]> FsManager::toPathBuffer(const std::string& path) {
-  // Allocate memory for the char array with a fixed size
-  std::unique_ptr<char[]> pathBuffer(new char[FS_MAX_PATH]);
+bool FsManager::moveFileIfExists(const FsPath& fromPath, const FsPath& toPath) {
+  Result result = fsFsRenameFile(&sdSystem, fromPath.c_str(), toPath.c_str());
 
-  // Ensure the input fits within FS_MAX_PATH
-  if (path.length() >= FS_MAX_PATH) {
-    tsl::changeTo<GuiError>("Input path exceeds maximum allowed length");
-  }
+  // "Path not found" is also what's returned when the toPath's folder is missing, so only skip if the fromPath really is gone:
+  if (result == 0x202 && !doesFileExist(fromPath)) { return false; }
+
+  GuiError::tryResult(result, "fsMoveFile");
+  return true;
+}
+
+/**
+ * Same as `moveFolder()`, except nothing happens if there's nothing at the fromPath
+ * 
+ * Returns whether anything was moved.
+ * Anything else that stops the move (such as the toPath's folder being missing) is still an error.
+ */
+bool FsManager::moveFolderIfExists(const FsPath& fromPath, const FsPath& toPath) {
+  Result result = fsFsRenameDirectory(&sdSystem, fromPath.c_str(), toPath.c_str());
 
-  // Copy the input string into the buffer
-  std::strcpy(pathBuffer.get(), path.c_str());
+  // "Path not found" is also what's returned when the toPath's folder is missing, so only skip if the fromPath really is gone:
+  if (result == 0x202 && !doesFolderExist(fromPath)) { return false; }
 
-  // Return the unique_ptr which will handle garbage collection automatically
-  return pathBuffer;
+  GuiError::tryResult(result, "fsMoveFolder");
+  return true;
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "fs_path.h"
+
+#include "ui/ui_error.h"
+
+#include <cstring>
+
+FsPath::FsPath() : size(0) {
+  this->buffer[0] = '\0';
+}
+
+FsPath::FsPath(const char* path) : FsPath(std::string_view(path)) {}
+
+FsPath::FsPath(std::string_view path) : FsPath() {
+  this->append(path);
+}
+
+FsPath::FsPath(const std::string& path) : FsPath(std::string_view(path)) {}
+
+/**
+ * Adds the text to the end of the path as-is
+ */
+FsPath& FsPath::append(std::string_view text) {
+
+  // Ensure the text fits within FS_MAX_PATH (leaving room for the null terminator)
+  if (this->size + text.size() >= FS_MAX_PATH) {
+    GuiError::fail("Input path exceeds maximum allowed length");
+  }
+
+  std::memcpy(this->buffer + this->size, text.data(), text.size());
+  this->size += text.size();
+  this->buffer[this->size] = '\0';
+
+  return *this;
+}
+
+/**
+ * Adds a '/' followed by the segment to the end of the path
+ */
+FsPath& FsPath::join(std::string_view segment) {
+  this->append("/");
+  return this->append(segment);
+}
+
+/**
+ * Removes the last segment (and the '/' before it) from the end of the path
+ */
+void FsPath::popSegment() {
+  std::size_t lastSlashIndex = this->view().rfind('/');
+  this->truncate(lastSlashIndex == std::string_view::npos ? 0 : lastSlashIndex);
+}
+
+/**
+ * Shortens the path to the specified length
+ */
+void FsPath::truncate(std::size_t length) {
+  if (length < this->size) {
+    this->size = length;
+    this->buffer[this->size] = '\0';
+  }
+}
+
+std::size_t FsPath::length() const {
+  return this->size;
+}
+
+bool FsPath::empty() const {
+  return this->size == 0;
+}
+
+const char* FsPath::c_str() const {
+  return this->buffer;
+}
+
+std::string_view FsPath::view() const {
+  return std::string_view(this->buffer, this->size);
+}
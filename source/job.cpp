@@ -0,0 +1,115 @@
+#include "job.h"
+
+#include <cstdlib>
+#include <utility>
+
+Job Job::promise_type::get_return_object() {
+  return Job(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+std::suspend_always Job::promise_type::initial_suspend() noexcept {
+  return {};
+}
+
+std::suspend_always Job::promise_type::final_suspend() noexcept {
+  return {};
+}
+
+void Job::promise_type::return_void() {}
+
+void Job::promise_type::unhandled_exception() {
+  abort();
+}
+
+bool Job::Awaiter::await_ready() const {
+  return this->job.isDone();
+}
+
+std::coroutine_handle<> Job::Awaiter::await_suspend(std::coroutine_handle<promise_type> parent) {
+  // Start the job straight away, and step it in place of the parent from then on:
+  parent.promise().child = this->job.handle;
+  return this->job.handle;
+}
+
+void Job::Awaiter::await_resume() {}
+
+/**
+ * A job with nothing to do
+ */
+Job::Job() : handle(nullptr) {}
+
+Job::Job(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+Job::Job(Job&& other) : handle(std::exchange(other.handle, nullptr)) {}
+
+Job& Job::operator=(Job&& other) {
+  if (this != &other) {
+    if (this->handle) { this->handle.destroy(); }
+    this->handle = std::exchange(other.handle, nullptr);
+  }
+  return *this;
+}
+
+Job::~Job() {
+  if (this->handle) { this->handle.destroy(); }
+}
+
+/**
+ * Pauses a job until it's stepped again
+ */
+std::suspend_always Job::pause() {
+  return {};
+}
+
+Job::Awaiter Job::operator co_await() && {
+  return Awaiter { std::move(*this) };
+}
+
+/**
+ * Runs the job until it next pauses
+ * 
+ * Returns false once it's done
+ */
+bool Job::step() {
+  if (this->isDone()) { return false; }
+
+  // Find the innermost job that's being awaited.
+  // Once it's done, the job awaiting it carries on instead:
+  std::coroutine_handle<promise_type> current = this->handle;
+  while (current.promise().child) {
+    if (current.promise().child.done()) {
+      current.promise().child = nullptr;
+      break;
+    }
+    current = current.promise().child;
+  }
+
+  current.resume();
+  return !this->isDone();
+}
+
+/**
+ * Runs the job until it's done or it pauses after the time is up (it always takes at least one step)
+ * 
+ * Returns false once it's done
+ */
+bool Job::runFor(u64 nanoseconds) {
+  u64 start = armGetSystemTick();
+
+  while (this->step()) {
+    if (armTicksToNs(armGetSystemTick() - start) >= nanoseconds) { return true; }
+  }
+
+  return false;
+}
+
+/**
+ * Runs the job until it's done
+ */
+void Job::run() {
+  while (this->step()) {}
+}
+
+bool Job::isDone() const {
+  return !this->handle || this->handle.done();
+}
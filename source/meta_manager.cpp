@@ -29,85 +29,29 @@ std::string MetaManager::getHexTitleId(const u64& titleId) {
 }
 
 /**
- * Parses the name of an entity from a folder name
+ * Parses the name, rating & locked status of an entity from a folder name in one pass, without copying anything
  */
-std::string MetaManager::parseName(const std::string& folderName) {
-  std::string name = folderName;
-
-  // Remove the rating substring from the folder name if there is one:
-  u8 rating = parseRating(folderName);
-  if (rating != 100) {
-    name = folderName.substr(0, folderName.length() - RATING_DELIMITER.length() - 2);
-  }
-
-  // Remove the locked character from the folder name if there is one:
-  if (parseLockedStatus(name)) {
-    name = name.substr(1);
-  }
-
-  // Now we have the actual name:
-  return name;
-}
-
-/**
- * Parses a rating of a mod from a folder name
- */
-u8 MetaManager::parseRating(const std::string& folderName) {
-  if (folderName.length() > RATING_DELIMITER.length() + 2) {
-
-    // Rating should be the last 2 characters:
-    std::string possibleRating = folderName.substr(folderName.length() - 2);
-
-    // The rating also gets delimited, so check that there is a delimitor before the digits as well
-    std::string possibleDelim = folderName.substr(
-      folderName.length() - RATING_DELIMITER.length() - 2,
-      RATING_DELIMITER.length()
-    );
-
-    // If the last characters check out as a delimitor with two digits, it's safe to assume those digits are the rating:
-    if (std::isdigit(possibleRating[0]) && std::isdigit(possibleRating[1]) && possibleDelim == RATING_DELIMITER) {
-      return std::stoi(possibleRating);
+MetaManager::FolderName MetaManager::parseFolderName(std::string_view folderName) {
+  FolderName parsed = { folderName, 100, false };
+  std::size_t suffixLength = RATING_DELIMITER.length() + 2;
+
+  // A rating is a delimiter followed by two digits at the end of the folder name (with something before it):
+  if (folderName.length() > suffixLength) {
+    std::string_view suffix = folderName.substr(folderName.length() - suffixLength);
+    char tens = suffix[suffixLength - 2];
+    char ones = suffix[suffixLength - 1];
+
+    if (std::isdigit(tens) && std::isdigit(ones) && suffix.starts_with(RATING_DELIMITER)) {
+      parsed.rating = (tens - '0') * 10 + (ones - '0');
+      parsed.name.remove_suffix(suffixLength);
     }
   }
 
-  // If no rating is detected in the folder name, use the default rating:
-  return 100;
-}
-
-/**
- * Parses whether a source is locked from randomization or not from the source's folder name
- */
-bool MetaManager::parseLockedStatus(const std::string& folderName) {
-  return folderName[0] == LOCKED_CHAR;
-}
-
-/**
- * Builds a folder name from a mod name and rating
- */
-std::string MetaManager::buildFolderName(const std::string& modName, const u8& rating, bool locked) {
-  std::string folderName = modName;
-
-  if (rating != 100) {
-    std::string ratingStr = std::to_string(rating);
-
-    if (rating < 10) {
-      ratingStr.insert(0, "0");
-    }
-
-    folderName += RATING_DELIMITER + ratingStr;
-  }
-
-  if (locked) {
-    folderName.insert(0, 1, LOCKED_CHAR);
+  // The locked character goes at the start of a source's folder name:
+  if (!parsed.name.empty() && parsed.name[0] == LOCKED_CHAR) {
+    parsed.locked = true;
+    parsed.name.remove_prefix(1);
   }
 
-  return folderName;
+  return parsed;
 }
-
-/**
- * Checks if the entity name belongs to a folder name
- */
-bool MetaManager::namesMatch(char* folderName, const std::string& entityName) {
-  std::string folderNameStr(folderName);
-  return parseName(folderNameStr) == entityName;
-}
\ No newline at end of file
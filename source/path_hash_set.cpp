@@ -0,0 +1,183 @@
+#include "path_hash_set.h"
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * Rounds down to a power of 2 (at least 1)
+ */
+static std::size_t floorPowerOf2(std::size_t n) {
+  std::size_t power = 1;
+  while (power * 2 <= n) {
+    power *= 2;
+  }
+  return power;
+}
+
+/**
+ * @param memoryBudget Bytes to use for the table & filter (allocated up front)
+ */
+PathHashSet::PathHashSet(std::size_t memoryBudget) : count(0), erasedCount(0) {
+
+  // Up to 3/4 of the budget goes to the table, and what's left of it to the filter
+  // (both are rounded down to powers of 2, so the hash can be masked instead of divided):
+  std::size_t slotCount = std::max<std::size_t>(floorPowerOf2(memoryBudget * 3 / 4 / sizeof(u64)), 16);
+  std::size_t filterBudget = memoryBudget > slotCount * sizeof(u64) ? memoryBudget - slotCount * sizeof(u64) : 0;
+  std::size_t filterWords = floorPowerOf2(filterBudget / sizeof(u64));
+
+  this->slots.reset(new u64[slotCount]);
+  this->slotMask = slotCount - 1;
+
+  this->filter.reset(new u64[filterWords]);
+  this->filterMask = filterWords * 64 - 1;
+
+  this->clear();
+}
+
+/**
+ * Hashes text (FNV-1a). Pass a previous hash as the seed to hash text that continues on from it.
+ */
+u64 PathHashSet::hash(std::string_view text, u64 seed) {
+  u64 hash = seed;
+  for (char c : text) {
+    hash ^= (u8) c;
+    hash *= 0x100000001B3;
+  }
+  return hash;
+}
+
+/**
+ * Adds the hash to the set
+ * 
+ * Returns false if the set was too full to add it
+ */
+bool PathHashSet::insert(u64 hash) {
+  u64 value = toSlotValue(hash);
+
+  if (this->contains(hash)) { return true; }
+
+  // Keep the table at most 3/4 full, so probing stays short:
+  if (this->count + 1 > this->maxSize()) { return false; }
+
+  if (this->count + this->erasedCount + 1 > this->maxSize()) {
+    this->rehash();
+  }
+
+  // Take the first free slot, reusing slots of erased hashes:
+  std::size_t i = value & this->slotMask;
+  while (this->slots[i] != EMPTY_SLOT && this->slots[i] != ERASED_SLOT) {
+    i = (i + 1) & this->slotMask;
+  }
+
+  if (this->slots[i] == ERASED_SLOT) {
+    this->erasedCount--;
+  }
+
+  this->slots[i] = value;
+  this->count++;
+  this->addToFilter(value);
+
+  return true;
+}
+
+void PathHashSet::erase(u64 hash) {
+  u64 value = toSlotValue(hash);
+  if (!this->mayContain(value)) { return; }
+
+  std::size_t i = this->findSlot(value);
+  if (this->slots[i] == value) {
+    // The filter can't have bits removed, so it's left as is (only costing a few extra probes):
+    this->slots[i] = ERASED_SLOT;
+    this->count--;
+    this->erasedCount++;
+  }
+}
+
+bool PathHashSet::contains(u64 hash) const {
+  u64 value = toSlotValue(hash);
+  if (!this->mayContain(value)) { return false; }
+
+  return this->slots[this->findSlot(value)] == value;
+}
+
+void PathHashSet::clear() {
+  std::memset(this->slots.get(), 0, (this->slotMask + 1) * sizeof(u64));
+  std::memset(this->filter.get(), 0, (this->filterMask + 1) / 8);
+  this->count = 0;
+  this->erasedCount = 0;
+}
+
+std::size_t PathHashSet::size() const {
+  return this->count;
+}
+
+/**
+ * Maximum number of hashes the set holds before `insert()` starts failing
+ */
+std::size_t PathHashSet::maxSize() const {
+  return (this->slotMask + 1) / 4 * 3;
+}
+
+u64 PathHashSet::toSlotValue(u64 hash) {
+  return hash <= ERASED_SLOT ? hash + 2 : hash;
+}
+
+/**
+ * Finds the slot holding the value, or the slot it should go in if it's not in the set
+ */
+std::size_t PathHashSet::findSlot(u64 value) const {
+  std::size_t i = value & this->slotMask;
+  while (this->slots[i] != EMPTY_SLOT && this->slots[i] != value) {
+    i = (i + 1) & this->slotMask;
+  }
+  return i;
+}
+
+bool PathHashSet::mayContain(u64 value) const {
+  std::size_t bit1 = value & this->filterMask;
+  std::size_t bit2 = (value >> 32) & this->filterMask;
+  return (this->filter[bit1 / 64] >> (bit1 % 64) & 1) && (this->filter[bit2 / 64] >> (bit2 % 64) & 1);
+}
+
+/**
+ * Adds the value to the filter (2 bits from different parts of the hash)
+ */
+void PathHashSet::addToFilter(u64 value) {
+  std::size_t bit1 = value & this->filterMask;
+  std::size_t bit2 = (value >> 32) & this->filterMask;
+  this->filter[bit1 / 64] |= (u64) 1 << (bit1 % 64);
+  this->filter[bit2 / 64] |= (u64) 1 << (bit2 % 64);
+}
+
+/**
+ * Re-inserts everything in place to clear out erased slots (without a second copy of the table)
+ */
+void PathHashSet::rehash() {
+  std::size_t slotCount = this->slotMask + 1;
+
+  // Start just after a slot that was always empty. No probe sequence runs through it,
+  // so every hash's probe sequence is gone through in order below:
+  std::size_t start = 0;
+  while (this->slots[start] != EMPTY_SLOT) {
+    start++;
+  }
+
+  for (std::size_t i = 0; i < slotCount; i++) {
+    if (this->slots[i] == ERASED_SLOT) {
+      this->slots[i] = EMPTY_SLOT;
+    }
+  }
+  std::memset(this->filter.get(), 0, (this->filterMask + 1) / 8);
+  this->erasedCount = 0;
+
+  // Each hash moves to the first free slot of its probe sequence, which is never past where it was:
+  for (std::size_t n = 1; n <= slotCount; n++) {
+    std::size_t i = (start + n) & this->slotMask;
+    u64 value = this->slots[i];
+    if (value == EMPTY_SLOT) { continue; }
+
+    this->slots[i] = EMPTY_SLOT;
+    this->slots[this->findSlot(value)] = value;
+    this->addToFilter(value);
+  }
+}
@@ -0,0 +1,138 @@
+#include "profiles.h"
+
+#include "constants.h"
+#include "fs_manager.h"
+
+#include <algorithm>
+
+/**
+ * Reads the profiles from the file (leaving none if there's no file)
+ */
+void ProfileList::load(const FsPath& path) {
+  this->profiles.clear();
+
+  FsManager::finishReplacingFile(path);
+  if (!FsManager::doesFileExist(path)) { return; }
+
+  std::string contents = FsManager::readFile(path);
+  std::string_view data(contents);
+
+  while (!data.empty()) {
+    std::size_t lineEnd = std::min(data.find('\n'), data.size());
+    std::string_view line = data.substr(0, lineEnd);
+    data.remove_prefix(std::min(lineEnd + 1, data.size()));
+
+    // In case the file was edited on a PC:
+    if (line.ends_with('\r')) {
+      line.remove_suffix(1);
+    }
+
+    if (line.size() >= 2 && line.front() == '[' && line.back() == ']') {
+      this->profiles.push_back({ std::string(line.substr(1, line.size() - 2)), {} });
+      continue;
+    }
+
+    // Anything that isn't a pick in a profile is skipped:
+    std::size_t groupEnd = line.find('/');
+    std::size_t sourceEnd = line.find('/', groupEnd + 1);
+    if (this->profiles.empty() || groupEnd == std::string_view::npos || sourceEnd == std::string_view::npos) { continue; }
+
+    this->profiles.back().picks.push_back({
+      std::string(line.substr(0, groupEnd)),
+      std::string(line.substr(groupEnd + 1, sourceEnd - groupEnd - 1)),
+      std::string(line.substr(sourceEnd + 1))
+    });
+  }
+}
+
+void ProfileList::save(const FsPath& path) const {
+  std::string data;
+
+  for (const Profile& profile : this->profiles) {
+    data.append("[").append(profile.name).append("]\n");
+
+    for (const Pick& pick : profile.picks) {
+      data.append(pick.group).append("/").append(pick.source).append("/").append(pick.mod).append("\n");
+    }
+  }
+
+  FsManager::replaceFile(path, data);
+}
+
+u32 ProfileList::count() const {
+  return this->profiles.size();
+}
+
+std::string_view ProfileList::name(u32 profile) const {
+  return this->profiles[profile].name;
+}
+
+/**
+ * Adds a profile with the mods that are active now, named after the first number that isn't taken
+ */
+void ProfileList::add(const Catalog& catalog) {
+  std::string name;
+  for (u32 number = 1; ; number++) {
+    name = "Profile " + std::to_string(number);
+
+    bool taken = std::ranges::any_of(this->profiles, [&name](const Profile& profile) { return profile.name == name; });
+    if (!taken) { break; }
+  }
+
+  this->profiles.push_back({ name, {} });
+  recordActiveMods(catalog, this->profiles.back().picks);
+}
+
+/**
+ * Replaces the profile's mods with the ones that are active now
+ */
+void ProfileList::update(u32 profile, const Catalog& catalog) {
+  recordActiveMods(catalog, this->profiles[profile].picks);
+}
+
+void ProfileList::remove(u32 profile) {
+  this->profiles.erase(this->profiles.begin() + profile);
+}
+
+/**
+ * Fills the plan with the changes needed for the profile's mods to be active
+ *
+ * Sources that already match the profile are left out (see `RandomPlan::add()`), as are
+ * sources the profile doesn't have and mods that can no longer be found.
+ */
+void ProfileList::plan(u32 profile, const Catalog& catalog, RandomPlan& plan) const {
+  plan.clear();
+
+  for (const Pick& pick : this->profiles[profile].picks) {
+    u32 group = catalog.findGroup(pick.group);
+    u32 source = catalog.findSource(group, pick.source);
+    if (source == Catalog::NONE) { continue; }
+
+    u32 mod = Catalog::NONE;
+    if (!pick.mod.empty()) {
+      mod = catalog.findMod(source, pick.mod);
+      if (mod == Catalog::NONE) { continue; }
+    }
+
+    plan.add(catalog, group, source, mod);
+  }
+}
+
+/**
+ * Records the mod that's active now for every source
+ */
+void ProfileList::recordActiveMods(const Catalog& catalog, std::vector<Pick>& picks) {
+  picks.clear();
+
+  for (u32 group : catalog.groups()) {
+    for (u32 source : catalog.sourcesOf(group)) {
+      u32 mod = catalog.activeMod(source);
+
+      picks.push_back({
+        std::string(catalog.groupName(group)),
+        std::string(catalog.sourceName(source)),
+        mod == Catalog::NONE ? std::string() : std::string(catalog.modName(mod))
+      });
+    }
+  }
+}
@@ -0,0 +1,141 @@
+#include "random_plan.h"
+
+/**
+ * Builds the table for the weights
+ * 
+ * Returns false if every weight is 0 (in which case nothing can be picked)
+ */
+bool AliasTable::build(const std::vector<u32>& weights) {
+  u32 count = weights.size();
+
+  this->total = 0;
+  for (u32 weight : weights) {
+    this->total += weight;
+  }
+
+  if (this->total == 0) { return false; }
+
+  // Scaled so each slot holds exactly `total`, keeping everything in whole numbers:
+  this->thresholds.resize(count);
+  this->aliases.resize(count);
+
+  this->small.clear();
+  this->large.clear();
+  for (u32 i = 0; i < count; i++) {
+    this->thresholds[i] = (u64) weights[i] * count;
+    this->aliases[i] = i;
+    (this->thresholds[i] < this->total ? this->small : this->large).push_back(i);
+  }
+
+  // Fill what's left of each under-full slot with part of an over-full one:
+  while (!this->small.empty() && !this->large.empty()) {
+    u32 under = this->small.back();
+    this->small.pop_back();
+    u32 over = this->large.back();
+
+    this->aliases[under] = over;
+    this->thresholds[over] -= this->total - this->thresholds[under];
+
+    if (this->thresholds[over] < this->total) {
+      this->large.pop_back();
+      this->small.push_back(over);
+    }
+  }
+
+  // Whatever's left fills its whole slot:
+  for (u32 i : this->large) {
+    this->thresholds[i] = this->total;
+  }
+  for (u32 i : this->small) {
+    this->thresholds[i] = this->total;
+  }
+
+  return true;
+}
+
+/**
+ * Gets the index of a weight, picked at random
+ */
+u32 AliasTable::pick(std::mt19937_64& random) const {
+  u32 slot = std::uniform_int_distribution<u32>(0, this->thresholds.size() - 1)(random);
+  u64 position = std::uniform_int_distribution<u64>(0, this->total - 1)(random);
+
+  return position < this->thresholds[slot] ? slot : this->aliases[slot];
+}
+
+/**
+ * @param resource Where the list of changes is allocated
+ */
+RandomPlan::RandomPlan(std::pmr::memory_resource* resource) : changeList(resource) {}
+
+/**
+ * Draws a mod for every unlocked source in the catalog, based upon the ratings
+ */
+void RandomPlan::draw(const Catalog& catalog) {
+  this->clear();
+
+  std::mt19937_64 random(randomGet64());
+  AliasTable table;
+  std::vector<u32> weights;
+
+  for (u32 group : catalog.groups()) {
+    for (u32 source : catalog.sourcesOf(group)) {
+      if (catalog.isSourceLocked(source)) { continue; }
+
+      Catalog::IdRange mods = catalog.modsOf(source);
+
+      // The first option is using no mod, followed by each of the source's mods:
+      weights.clear();
+      weights.push_back(catalog.sourceRating(source));
+      for (u32 mod : mods) {
+        weights.push_back(catalog.modRating(mod));
+      }
+
+      // Just treat it as locked if all ratings are 0 for some reason:
+      if (!table.build(weights)) { continue; }
+
+      u32 option = table.pick(random);
+      this->add(catalog, group, source, option == 0 ? Catalog::NONE : mods[option - 1]);
+    }
+  }
+}
+
+/**
+ * Adds a change to the plan, unless the mod is already the source's active mod
+ */
+void RandomPlan::add(const Catalog& catalog, u32 group, u32 source, u32 mod) {
+  u32 activeMod = catalog.activeMod(source);
+
+  // No need to do anything if the mod is also the currently-active one:
+  if (mod == activeMod) { return; }
+
+  this->changeList.push_back({ group, source, mod });
+
+  if (activeMod != Catalog::NONE) {
+    this->files += catalog.modFileCount(activeMod);
+  }
+  if (mod != Catalog::NONE) {
+    this->files += catalog.modFileCount(mod);
+  }
+}
+
+/**
+ * Empties the plan
+ */
+void RandomPlan::clear() {
+  this->changeList.clear();
+  this->files = 0;
+}
+
+const std::pmr::vector<RandomPlan::Change>& RandomPlan::changes() const {
+  return this->changeList;
+}
+
+/**
+ * Number of files that are going to be moved, either into Atmosphere's folder or back to their mod's folder
+ * 
+ * Mods that are already active count what's in their list of moved files (see `Catalog::modFileCount()`)
+ */
+u64 RandomPlan::fileCount() const {
+  return this->files;
+}
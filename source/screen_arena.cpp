@@ -0,0 +1,7 @@
+#include "screen_arena.h"
+
+ScreenArena::ScreenArena() : resource(this->initial, sizeof(this->initial)) {}
+
+std::pmr::memory_resource* ScreenArena::get() {
+  return &this->resource;
+}
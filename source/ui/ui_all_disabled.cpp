@@ -9,6 +9,9 @@ tsl::elm::Element* GuiAllDisabled::createUI() {
   this->items = new tsl::elm::List();
 
   this->items->addItem(new tsl::elm::CategoryHeader("Disable all active mods?"));
+  this->items->addItem(new tsl::elm::CategoryHeader(
+    std::to_string(controller.activeSourceCount()) + " mods are active"
+  ));
 
   auto* no = new tsl::elm::ListItem("Cancel");
   no->setClickListener([](u64 keys) {
@@ -22,10 +25,11 @@ tsl::elm::Element* GuiAllDisabled::createUI() {
   this->yes = new tsl::elm::ListItem("OK");
   this->yes->setClickListener([this](u64 keys) {
     if (keys & HidNpadButton_A) {
-      controller.deactivateAll();
-      removeFocus(this->yes);
-      this->items->clear();
-      this->items->addItem(new tsl::elm::ListItem("All mods have been disabled."));
+
+      // Begin disabling mods in the background
+      this->status.start(this->items, [](Progress& progress) {
+        controller.deactivateAll(progress);
+      });
       return true;
     }
     return false;
@@ -39,6 +43,10 @@ tsl::elm::Element* GuiAllDisabled::createUI() {
   return frame;
 }
 
+void GuiAllDisabled::update() {
+  this->status.update();
+}
+
 bool GuiAllDisabled::handleInput(
   u64 keysDown,
   u64 keysHeld,
@@ -47,6 +55,9 @@ bool GuiAllDisabled::handleInput(
   HidAnalogStickState joyStickPosRight
 ) {
   if (keysDown & HidNpadButton_B) {
+    // Leaving while mods are being disabled stops after the current one instead:
+    if (this->status.stop()) { return true; }
+
     tsl::goBack();
     return true;
   }
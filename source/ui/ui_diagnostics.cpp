@@ -0,0 +1,71 @@
+#include "ui/ui_diagnostics.h"
+
+#ifdef ALCHEMIST_DIAGNOSTICS
+
+#include "constants.h"
+
+#include <string>
+
+/**
+ * Formats a number of bytes in KiB
+ */
+static std::string toKiB(s64 bytes) {
+  return std::to_string(bytes / 1024) + " KiB";
+}
+
+GuiDiagnostics::GuiDiagnostics() {}
+
+tsl::elm::Element* GuiDiagnostics::createUI() {
+  auto frame = new tsl::elm::OverlayFrame("State Alchemist", "Diagnostics");
+  auto list = new tsl::elm::List();
+
+  auto* dump = new tsl::elm::ListItem("Save to SD Card");
+  dump->setClickListener([dump](u64 keys) {
+    if (keys & HidNpadButton_A) {
+      Diagnostics::dump(FsPath(ALCHEMIST_PATH).append(DIAGNOSTICS_NAME));
+      dump->setValue(DIAGNOSTICS_NAME);
+      return true;
+    }
+    return false;
+  });
+  list->addItem(dump);
+
+  list->addItem(new tsl::elm::CategoryHeader("Overall"));
+  list->addItem(new tsl::elm::ListItem("Allocated now", toKiB(Diagnostics::getLiveBytes())));
+  list->addItem(new tsl::elm::ListItem("Allocated at most", toKiB(Diagnostics::getPeakLiveBytes())));
+  list->addItem(new tsl::elm::ListItem("Heap in use", toKiB(Diagnostics::getHeapBytes())));
+  list->addItem(new tsl::elm::ListItem(
+    "Process memory", toKiB(Diagnostics::getProcessBytes()) + " / " + toKiB(Diagnostics::getProcessLimit())
+  ));
+
+  // Each screen & operation, along with the most allocated at once while it was running:
+  for (u32 i = 0; i < Diagnostics::getRecordCount(); i++) {
+    const Diagnostics::Record& record = Diagnostics::getRecord(i);
+
+    list->addItem(new tsl::elm::CategoryHeader(std::string(record.name) + " (" + std::to_string(record.runs) + " runs)"));
+    list->addItem(new tsl::elm::ListItem("Peak", toKiB(record.peakLiveBytes)));
+    list->addItem(new tsl::elm::ListItem(
+      "Allocated", std::to_string(record.allocations) + " / " + toKiB(record.allocatedBytes)
+    ));
+    list->addItem(new tsl::elm::ListItem("Kept after last run", toKiB(record.retainedBytes)));
+  }
+
+  frame->setContent(list);
+  return frame;
+}
+
+bool GuiDiagnostics::handleInput(
+  u64 keysDown,
+  u64 keysHeld,
+  const HidTouchState &touchPos,
+  HidAnalogStickState joyStickPosLeft,
+  HidAnalogStickState joyStickPosRight
+) {
+  if (keysDown & HidNpadButton_B) {
+    tsl::goBack();
+    return true;
+  }
+  return false;
+}
+
+#endif // ALCHEMIST_DIAGNOSTICS
@@ -1,5 +1,7 @@
 #include "ui/ui_error.h"   // Include the header file
 
+#include "worker.h"
+
 GuiError::GuiError(std::string message) {
   this->message = message;
 }
@@ -33,7 +35,21 @@ bool GuiError::handleInput(
  */
 void GuiError::tryResult(const Result& r, const std::string& alchemyCode) {
   if (R_FAILED(r)) {
-    tsl::changeTo<GuiError>("Error: " + alchemyCode + " " + std::to_string(r));
-    abort();
+    fail("Error: " + alchemyCode + " " + std::to_string(r));
   }
 }
+
+/**
+ * Displays the error to the user and stops
+ *
+ * On a worker's thread, only the task is stopped, and its screen displays the error instead (see WorkerStatus),
+ * since only the UI thread may change screens.
+ */
+void GuiError::fail(const std::string& message) {
+  if (Worker::isWorkerThread()) {
+    Worker::fail(message);
+  }
+
+  tsl::changeTo<GuiError>(message);
+  abort();
+}
@@ -12,7 +12,8 @@ tsl::elm::Element* GuiGroups::createUI() {
 
   auto list = new tsl::elm::List();
 
-  std::vector<std::string> groups = controller.loadGroups(true);
+  const Catalog& catalog = controller.getCatalog();
+  Catalog::IdRange groups = catalog.groups();
 
   // When there are no groups for some odd reason:
   if (groups.empty()) {
@@ -22,8 +23,8 @@ tsl::elm::Element* GuiGroups::createUI() {
 
   list->addItem(new tsl::elm::CategoryHeader("\uE0E0 View group    |    \uE0E2 View group (for locking)"));
 
-  for (const std::string &group : groups) {
-    auto *item = new tsl::elm::ListItem(group);
+  for (u32 group : groups) {
+    auto *item = new tsl::elm::ListItem(std::string(catalog.groupName(group)));
 
     item->setClickListener([this, group](u64 keys) {
       if (keys & HidNpadButton_A) {
@@ -7,9 +7,10 @@
 GuiLocks::GuiLocks() {}
 
 tsl::elm::Element* GuiLocks::createUI() {
-  auto frame = new tsl::elm::OverlayFrame("State Alchemist", controller.group);
+  const Catalog& catalog = controller.getCatalog();
+  auto frame = new tsl::elm::OverlayFrame("State Alchemist", std::string(catalog.groupName(controller.group)));
 
-  std::map<std::string, bool> sources = controller.loadSourceLocks();
+  Catalog::IdRange sources = catalog.sourcesOf(controller.group);
 
   // For when the group is empty for some reason:
   if (sources.empty()) {
@@ -17,40 +18,49 @@ tsl::elm::Element* GuiLocks::createUI() {
     return frame;
   }
 
-  auto list = new tsl::elm::List();
+  // Toggles are only made for the rows on screen, and filled in from the catalog as they're scrolled to:
+  this->list = new VirtualList(
+    sources.size(),
+    [this]() {
+      auto* item = new tsl::elm::ToggleListItem("", false);
+      item->setClickListener([this, item](u64 keys) {
+        if (keys & HidNpadButton_A) {
+          u32 source = controller.getCatalog().sourcesOf(controller.group)[this->list->rowOf(item)];
 
-  list->addItem(new tsl::elm::CategoryHeader("Locking Mods"));
-  list->addItem(new tsl::elm::CategoryHeader("This is for the \"Pick at Random\" option"));
-  list->addItem(new tsl::elm::CategoryHeader("Prevents the mod from changing"));
+          if (controller.getCatalog().isSourceLocked(source)) {
+            controller.unlockSource(source);
+          } else {
+            controller.lockSource(source);
+          }
+          return true;
+        }
+        return false;
+      });
+      return item;
+    },
+    [this](tsl::elm::Element* element, u32 row) {
+      const Catalog& catalog = controller.getCatalog();
+      u32 source = catalog.sourcesOf(controller.group)[row];
+      u32 activeMod = catalog.activeMod(source);
 
-  // List all the group's source with active mods for locking/unlocking:
-  for (const auto& [name, locked]: sources) {
-    std::string activeMod = controller.getActiveMod(name);
+      this->label.assign(catalog.sourceName(source));
+      if (activeMod == Catalog::NONE) {
+        this->label.append(" - no mod active");
+      } else {
+        this->label.append(" (").append(catalog.modName(activeMod)).append(")");
+      }
 
-    std::string label;
-    if (activeMod.empty()) {
-      label = name + " - no mod active";
-    } else {
-      label = name + " (" + activeMod + ")";
+      auto* item = static_cast<tsl::elm::ToggleListItem*>(element);
+      item->setText(this->label);
+      item->setState(catalog.isSourceLocked(source));
     }
+  );
 
-    auto *item = new tsl::elm::ToggleListItem(label, locked);
-    item->setClickListener([name, locked](u64 keys) {
-      if (keys & HidNpadButton_A) {
-        if (locked) {
-          controller.unlockSource(name);
-        } else {
-          controller.lockSource(name);
-        }
-        return true;
-      }
-      return false;
-    });
-
-    list->addItem(item);
-  }
+  this->list->addHeader(new tsl::elm::CategoryHeader("Locking Mods"));
+  this->list->addHeader(new tsl::elm::CategoryHeader("This is for the \"Pick at Random\" option"));
+  this->list->addHeader(new tsl::elm::CategoryHeader("Prevents the mod from changing"));
 
-  frame->setContent(list);
+  frame->setContent(this->list);
   return frame;
 }
 
@@ -62,7 +72,7 @@ bool GuiLocks::handleInput(
   HidAnalogStickState joyStickPosRight
 ) {
   if (keysDown & HidNpadButton_B) {
-    controller.group = "";
+    controller.group = Catalog::NONE;
     tsl::goBack();
     return true;
   }
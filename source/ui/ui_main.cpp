@@ -2,6 +2,8 @@
 #include "ui/ui_groups.h"
 #include "ui/ui_all_disabled.h"
 #include "ui/ui_random.h"
+#include "ui/ui_profiles.h"
+#include "ui/ui_diagnostics.h"
 
 #include "controller.h"
 #include "constants.h"
@@ -44,6 +46,28 @@ tsl::elm::Element* GuiMain::createUI() {
   });
   list->addItem(random);
 
+  auto* profiles = new tsl::elm::ListItem("Profiles");
+  profiles->setClickListener([](u64 keys) {
+    if (keys & HidNpadButton_A) {
+      tsl::changeTo<GuiProfiles>();
+      return true;
+    }
+    return false;
+  });
+  list->addItem(profiles);
+
+  // For when the files in mods' folders were changed on another device (folders being added, removed or renamed is noticed automatically):
+  auto* rescan = new tsl::elm::ListItem("Rescan Mod Folders");
+  rescan->setClickListener([rescan](u64 keys) {
+    if (keys & HidNpadButton_A) {
+      controller.rescan();
+      rescan->setValue("Done");
+      return true;
+    }
+    return false;
+  });
+  list->addItem(rescan);
+
   // A little extra space above the option for disabling all:
   list->addItem(new tsl::elm::CategoryHeader("-------------------------"));
 
@@ -62,4 +86,22 @@ tsl::elm::Element* GuiMain::createUI() {
   frame->setContent(list);
 
   return frame;
-}
\ No newline at end of file
+}
+
+bool GuiMain::handleInput(
+  u64 keysDown,
+  u64 keysHeld,
+  const HidTouchState &touchPos,
+  HidAnalogStickState joyStickPosLeft,
+  HidAnalogStickState joyStickPosRight
+) {
+#ifdef ALCHEMIST_DIAGNOSTICS
+  // Hidden, since it's only for development:
+  if ((keysHeld & HidNpadButton_ZL) && (keysDown & HidNpadButton_ZR)) {
+    tsl::changeTo<GuiDiagnostics>();
+    return true;
+  }
+#endif
+
+  return false;
+}
@@ -3,97 +3,158 @@
 
 #include <string>
 
+#include "constants.h"
 #include "controller.h"
 
 GuiMods::GuiMods() { }
 
 tsl::elm::Element* GuiMods::createUI() {
-  auto frame = new tsl::elm::OverlayFrame("State Alchemist", controller.source);
-
-  std::vector<std::string> mods = controller.loadMods(true);
-  std::string activeMod = controller.getActiveMod(controller.source);
-
-  auto list = new tsl::elm::List();
-
-  list->addItem(new tsl::elm::CategoryHeader("Turn Mods On/Off"));
-  // Used to disable any active mod:
-  auto *defaultToggle = new tsl::elm::ToggleListItem("Default " + controller.source, activeMod == "");
-  defaultToggle->setStateChangedListener([this](bool state) {
-    if (state) { this->activateDefaultMod(); }
-    else { this->deactivateDefaultMod(); }
-  });
-
-  // Add the default option:
-  this->toggles.push_back(defaultToggle);
-  list->addItem(this->toggles[0]);
-
-  // Add a toggle for each mod:
-  for (const std::string &mod : mods) {
-    auto *item = new tsl::elm::ToggleListItem(mod, mod == activeMod);
-    item->setStateChangedListener([this, item, mod](bool state) {
-      if (state) { this->activateMod(mod, item); }
-      else { this->deactivateMod(mod); }
-    });
-
-    this->toggles.push_back(item);
-    list->addItem(item);
-  }
+  const Catalog& catalog = controller.getCatalog();
+  this->sourceName = catalog.sourceName(controller.source);
+  auto frame = new tsl::elm::OverlayFrame("State Alchemist", this->sourceName);
+
+  // Toggles are only made for the rows on screen, and filled in from the catalog as they're scrolled to:
+  this->list = new VirtualList(
+    catalog.modsOf(controller.source).size() + 1,
+    [this]() {
+      auto* item = new tsl::elm::ToggleListItem("", false);
+      item->setStateChangedListener([this, item](bool state) {
+        this->toggle(this->list->rowOf(item), state);
+      });
+      return item;
+    },
+    [this](tsl::elm::Element* element, u32 row) {
+      this->bindToggle(static_cast<tsl::elm::ToggleListItem*>(element), row);
+    }
+  );
+
+  this->list->addHeader(new tsl::elm::CategoryHeader("Turn Mods On/Off"));
 
-  frame->setContent(list);
+  frame->setContent(this->list);
   return frame;
 }
 
 /**
- * Activates the specified mod, thereby deactivating the current active one
+ * Gets the mod shown in a row (Catalog::NONE for the default option)
+ */
+u32 GuiMods::modOf(u32 row) const {
+  return row == 0 ? Catalog::NONE : controller.getCatalog().modsOf(controller.source)[row - 1];
+}
+
+/**
+ * Fills in a toggle with a row's mod & whether it's active
  */
-void GuiMods::activateMod(const std::string& mod, tsl::elm::ToggleListItem* modToggle) {
-  controller.deactivateMod();
-  controller.activateMod(mod);
-
-  // Untoggle all other mods:
-  for (const auto &toggle: this->toggles) {
-    if (toggle->getText() != mod) {
-      toggle->setState(false);
+void GuiMods::bindToggle(tsl::elm::ToggleListItem* toggle, u32 row) {
+  const Catalog& catalog = controller.getCatalog();
+  u32 mod = this->modOf(row);
+
+  toggle->setText(mod == Catalog::NONE ? "Default " + this->sourceName : std::string(catalog.modName(mod)));
+
+  // While a mod is being switched to, it's shown as on (along with how far along it is):
+  if (this->switching) {
+    toggle->setState(row == this->jobRow);
+    if (row == this->jobRow) {
+      toggle->setValue(this->progressText(), true);
     }
+  } else {
+    toggle->setState(mod == catalog.activeMod(controller.source));
   }
+}
 
-  // Edge-case: If all the mod's files have conflicts, none of them will be transferred, so the mod won't actually get activated.
-  // Untoggle to correctly reflect the state, and notify the user to prevent confusion:
-  if (controller.getActiveMod(controller.source) != mod) {
-    modToggle->setState(false);
-    this->toggles[0]->setState(true);
-    tsl::changeTo<GuiError>("Cannot enable. All mod files conflict with active files.");
+/**
+ * Handles a row's toggle being turned on/off
+ * 
+ * Turning on a mod activates it (deactivating the current active one), turning one off activates the default option,
+ * and the default option can't be turned off unless another mod is being activated
+ */
+void GuiMods::toggle(u32 row, bool state) {
+  if (this->switching || (row == 0 && !state)) {
+    this->list->refresh();
+    return;
+  }
+
+  if (state) {
+    this->startSwitch(row, this->modOf(row));
+  } else {
+    this->startSwitch(0, Catalog::NONE);
   }
 }
 
 /**
- * Deactivates the specified mod, thereby making the default option the active one
+ * Starts switching the source to the mod (or to no mod with Catalog::NONE)
  */
-void GuiMods::deactivateMod(const std::string& mod) {
-  controller.deactivateMod();
-  this->toggles[0]->setState(true);
+void GuiMods::startSwitch(u32 row, u32 mod) {
+  const Catalog& catalog = controller.getCatalog();
+  u32 activeMod = catalog.activeMod(controller.source);
+
+  // Files to move, for showing progress on the toggle:
+  this->jobFileCount = 0;
+  if (activeMod != Catalog::NONE) { this->jobFileCount += catalog.modFileCount(activeMod); }
+  if (mod != Catalog::NONE) { this->jobFileCount += catalog.modFileCount(mod); }
+
+  this->progress.files = 0;
+  this->switching = true;
+  this->jobRow = row;
+  this->jobMod = mod;
+  this->job = this->switchMod(mod);
+
+  this->list->refresh();
 }
 
 /**
- * Activates the default vanilla option, thereby deactivating whichever mod is currently active
+ * Deactivates the active mod, then activates the new one
  */
-void GuiMods::activateDefaultMod() {
-  controller.deactivateMod();
+Job GuiMods::switchMod(u32 mod) {
+  controller.setProgress(&this->progress);
 
-  // Untoggle all mods, but keep the default option toggled:
-  for (const auto &toggle: this->toggles) {
-    toggle->setState(false);
+  co_await controller.deactivateModJob();
+  if (mod != Catalog::NONE) {
+    co_await controller.activateModJob(mod);
   }
-  this->toggles[0]->setState(true);
+
+  controller.setProgress(nullptr);
+}
+
+void GuiMods::update() {
+  if (!this->switching) { return; }
+
+  // Move files for part of the frame, then let the menu draw:
+  if (this->job.runFor(JOB_FRAME_BUDGET_NS)) {
+    if (auto* toggle = static_cast<tsl::elm::ToggleListItem*>(this->list->elementFor(this->jobRow))) {
+      toggle->setValue(this->progressText(), true);
+    }
+    return;
+  }
+
+  this->finishSwitch();
 }
 
 /**
- * The default option cannot be deactivated unless another mod is being activated
- * 
- * Therefore, if the user attempts to deactivate the default option, this will keep it activated
+ * Updates the toggles once the job is done
+ */
+void GuiMods::finishSwitch() {
+  this->switching = false;
+  this->list->refresh();
+
+  // Edge-case: If all the mod's files have conflicts, none of them will be transferred, so the mod won't actually get activated.
+  // The toggles already show the default option instead, so notify the user to prevent confusion:
+  if (this->jobMod != Catalog::NONE && controller.getCatalog().activeMod(controller.source) != this->jobMod) {
+    tsl::changeTo<GuiError>("Cannot enable. All mod files conflict with active files.");
+  }
+}
+
+std::string GuiMods::progressText() const {
+  return std::to_string(this->progress.files) + "/" + std::to_string(this->jobFileCount);
+}
+
+/**
+ * Finishes moving files if the menu is closed part-way through
  */
-void GuiMods::deactivateDefaultMod() {
-  this->toggles[0]->setState(true);
+GuiMods::~GuiMods() {
+  this->job.run();
+
+  // Switching mods here one at a time builds the index once, so it's kept until the menu is closed:
+  controller.releaseAtmosphereIndex();
 }
 
 bool GuiMods::handleInput(
@@ -104,7 +165,10 @@ bool GuiMods::handleInput(
   HidAnalogStickState joyStickPosRight
 ) {
   if (keysDown & HidNpadButton_B) {
-    controller.source = "";
+    // Wait for the mod being switched to, since it needs the source:
+    if (this->switching) { return true; }
+
+    controller.source = Catalog::NONE;
     tsl::goBack();
     return true;
   }
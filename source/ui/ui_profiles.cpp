@@ -0,0 +1,133 @@
+#include "ui/ui_profiles.h"
+
+#include "controller.h"
+
+/**
+ * UI for saving which mods are active as a profile, and applying saved profiles
+ */
+GuiProfiles::GuiProfiles() {}
+
+tsl::elm::Element* GuiProfiles::createUI() {
+  auto frame = new tsl::elm::OverlayFrame("State Alchemist", "Profiles");
+  this->items = new tsl::elm::List();
+
+  this->countChanges();
+  this->showProfiles();
+
+  frame->setContent(this->items);
+  return frame;
+}
+
+/**
+ * Plans each profile to count how many sources it would change
+ */
+void GuiProfiles::countChanges() {
+  u32 profileCount = controller.getProfiles().count();
+  this->changeCounts.clear();
+
+  for (u32 profile = 0; profile < profileCount; profile++) {
+    // Only the sources that differ from the profile are changed when it's applied:
+    controller.planProfile(profile, this->plan);
+    this->changeCounts.push_back(this->plan.changes().size());
+  }
+}
+
+/**
+ * Fills the menu with an option for each profile (along with how many sources it would change)
+ */
+void GuiProfiles::showProfiles() {
+  this->items->clear();
+
+  auto* add = new tsl::elm::ListItem("Save active mods as a profile");
+  add->setClickListener([this, add](u64 keys) {
+    if (keys & HidNpadButton_A) {
+      controller.addProfile();
+      this->changeCounts.push_back(0);
+      removeFocus(add);
+      this->showProfiles();
+      return true;
+    }
+    return false;
+  });
+  this->items->addItem(add);
+
+  const ProfileList& profiles = controller.getProfiles();
+  if (profiles.count() == 0) {
+    this->items->addItem(new tsl::elm::CategoryHeader("No profiles saved yet"));
+    return;
+  }
+
+  this->items->addItem(new tsl::elm::CategoryHeader("\uE0E0 Apply    |    \uE0E2 Overwrite    |    \uE0E3 Delete"));
+
+  for (u32 profile = 0; profile < profiles.count(); profile++) {
+    auto* item = new tsl::elm::ListItem(std::string(profiles.name(profile)));
+
+    u32 changeCount = this->changeCounts[profile];
+    if (changeCount == 0) {
+      item->setValue("Active");
+    } else {
+      item->setValue(std::to_string(changeCount) + " changes", true);
+    }
+
+    item->setClickListener([this, item, profile](u64 keys) {
+      if (keys & HidNpadButton_A) {
+        removeFocus(item);
+        this->apply(profile);
+        return true;
+      }
+
+      if (keys & HidNpadButton_X) {
+        controller.updateProfile(profile);
+        this->changeCounts[profile] = 0;
+        removeFocus(item);
+        this->showProfiles();
+        return true;
+      }
+
+      if (keys & HidNpadButton_Y) {
+        controller.deleteProfile(profile);
+        this->changeCounts.erase(this->changeCounts.begin() + profile);
+        removeFocus(item);
+        this->showProfiles();
+        return true;
+      }
+
+      return false;
+    });
+
+    this->items->addItem(item);
+  }
+}
+
+/**
+ * Starts changing the mods that differ from the profile
+ */
+void GuiProfiles::apply(u32 profile) {
+  controller.planProfile(profile, this->plan);
+
+  // Begin changing mods in the background
+  this->status.start(this->items, [this](Progress& progress) {
+    controller.applyPlan(this->plan, progress);
+  });
+}
+
+void GuiProfiles::update() {
+  this->status.update();
+}
+
+bool GuiProfiles::handleInput(
+  u64 keysDown,
+  u64 keysHeld,
+  const HidTouchState &touchPos,
+  HidAnalogStickState joyStickPosLeft,
+  HidAnalogStickState joyStickPosRight
+) {
+  if (keysDown & HidNpadButton_B) {
+    // Leaving while mods are being changed stops after the current one instead:
+    if (this->status.stop()) { return true; }
+
+    tsl::goBack();
+    return true;
+  }
+  return false;
+}
@@ -5,16 +5,17 @@
 /**
  * UI for activating / deactivating mods at random
  */
-GuiRandom::GuiRandom() {}
+GuiRandom::GuiRandom() : plan(controller.planRandom(this->arena.get())) {}
 
 tsl::elm::Element* GuiRandom::createUI() {
   auto frame = new tsl::elm::OverlayFrame("State Alchemist", "Random Mods");
   this->items = new tsl::elm::List();
 
   this->items->addItem(new tsl::elm::CategoryHeader("This will enable mods at random"));
-  this->items->addItem(new tsl::elm::CategoryHeader("Tesla menu will freeze briefly"));
-  this->items->addItem(new tsl::elm::CategoryHeader("(up to a minute if there are many mods)"));
-  this->items->addItem(new tsl::elm::CategoryHeader("This menu will change when it is done"));
+  this->items->addItem(new tsl::elm::CategoryHeader(
+    std::to_string(this->plan.changes().size()) + " sources & "
+    + std::to_string(this->plan.fileCount()) + " files will change"
+  ));
 
   auto* no = new tsl::elm::ListItem("Cancel");
   no->setClickListener([](u64 keys) {
@@ -29,23 +30,10 @@ tsl::elm::Element* GuiRandom::createUI() {
   this->yes->setClickListener([this](u64 keys) {
     if (keys & HidNpadButton_A) {
 
-      // Begin randomly choosing mods
-      controller.randomize();
-      removeFocus(this->yes);
-      this->items->clear();
-
-      // Create new form for when randomization finishes
-      auto* finished = new tsl::elm::ListItem("Finished!");
-      finished->setClickListener([](u64 keys) {
-        if (keys & HidNpadButton_A) {
-          tsl::goBack();
-          return true;
-        }
-        return false;
+      // Begin randomly choosing mods in the background
+      this->status.start(this->items, [this](Progress& progress) {
+        controller.applyPlan(this->plan, progress);
       });
-
-      this->items->addItem(finished);
-      this->items->addItem(new tsl::elm::CategoryHeader("Please relaunch game now"));
       return true;
     }
     return false;
@@ -59,6 +47,10 @@ tsl::elm::Element* GuiRandom::createUI() {
   return frame;
 }
 
+void GuiRandom::update() {
+  this->status.update();
+}
+
 bool GuiRandom::handleInput(
   u64 keysDown,
   u64 keysHeld,
@@ -67,8 +59,11 @@ bool GuiRandom::handleInput(
   HidAnalogStickState joyStickPosRight
 ) {
   if (keysDown & HidNpadButton_B) {
+    // Leaving while mods are being changed stops after the current one instead:
+    if (this->status.stop()) { return true; }
+
     tsl::goBack();
     return true;
   }
   return false;
-}
\ No newline at end of file
+}
@@ -1,52 +1,67 @@
 #include "ui/ui_ratings.h"
 
 #include "controller.h"
-#include <fs_manager.h>
 
 GuiRatings::GuiRatings() { }
 
 tsl::elm::Element* GuiRatings::createUI() {
-  auto frame = new tsl::elm::OverlayFrame("State Alchemist", controller.source);
-
-  std::map<std::string, u8> savedRatings = controller.loadRatings();
-  this->savedDefaultRating = controller.loadDefaultRating(controller.source);
-  this->defaultRating = this->savedDefaultRating;
-
-  // Used for when no mod is active:
-  auto *defaultSlider = new tsl::elm::TrackBar(" ");
-  defaultSlider->setProgress(this->defaultRating);
-
-  defaultSlider->setValueChangedListener([this](u8 value) {
-    this->defaultRating = value;
-  });
-  
-  auto list = new tsl::elm::List();
-
-  list->addItem(new tsl::elm::CategoryHeader("Set how likely each mod is to be picked"));
-  list->addItem(new tsl::elm::CategoryHeader("This is for the \"Pick at Random\" option"));
-
-  // Add the default option with the header:
-  list->addItem(new tsl::elm::CategoryHeader("Default " + controller.source));
-  list->addItem(defaultSlider);
-
-  // Add a header & slider for each mod:
-  for (const auto& [name, rating]: savedRatings) {
-    list->addItem(new tsl::elm::CategoryHeader(name));
-
-    auto slider = new tsl::elm::TrackBar(" ");
-    slider->setProgress(rating);
-
-    slider->setValueChangedListener([this, name](u8 value) {
-      this->changedRatings[name] = value;
-    });
+  const Catalog& catalog = controller.getCatalog();
+  std::string sourceName(catalog.sourceName(controller.source));
+  auto frame = new tsl::elm::OverlayFrame("State Alchemist", sourceName);
+
+  this->defaultRating = catalog.sourceRating(controller.source);
+
+  // Sliders are only made for the rows on screen, and filled in from the catalog (or what's been changed) as they're scrolled to:
+  this->list = new VirtualList(
+    catalog.modsOf(controller.source).size() + 1,
+    [this]() {
+      auto* slider = new tsl::elm::TrackBar(" ");
+      slider->setValueChangedListener([this, slider](u8 value) {
+        u32 mod = this->modOf(this->list->rowOf(slider));
+
+        if (mod == Catalog::NONE) {
+          this->defaultRating = value;
+        } else {
+          this->changedRatings[mod] = value;
+        }
+      });
+      return slider;
+    },
+    [this](tsl::elm::Element* element, u32 row) {
+      u32 mod = this->modOf(row);
+      auto changed = this->changedRatings.find(mod);
+
+      u8 rating;
+      if (mod == Catalog::NONE) {
+        rating = this->defaultRating;
+      } else if (changed != this->changedRatings.end()) {
+        rating = changed->second;
+      } else {
+        rating = controller.getCatalog().modRating(mod);
+      }
+
+      static_cast<tsl::elm::TrackBar*>(element)->setProgress(rating);
+    },
+    [this, sourceName](u32 row) {
+      u32 mod = this->modOf(row);
+      return mod == Catalog::NONE ? "Default " + sourceName : std::string(controller.getCatalog().modName(mod));
+    }
+  );
 
-    list->addItem(slider);
-  }
+  this->list->addHeader(new tsl::elm::CategoryHeader("Set how likely each mod is to be picked"));
+  this->list->addHeader(new tsl::elm::CategoryHeader("This is for the \"Pick at Random\" option"));
 
-  frame->setContent(list);
+  frame->setContent(this->list);
   return frame;
 }
 
+/**
+ * Gets the mod shown in a row (Catalog::NONE for the default option)
+ */
+u32 GuiRatings::modOf(u32 row) const {
+  return row == 0 ? Catalog::NONE : controller.getCatalog().modsOf(controller.source)[row - 1];
+}
+
 bool GuiRatings::handleInput(
   u64 keysDown,
   u64 keysHeld,
@@ -55,15 +70,11 @@ bool GuiRatings::handleInput(
   HidAnalogStickState joyStickPosRight
 ) {
   if (keysDown & HidNpadButton_B) {
-    controller.saveRatings(this->changedRatings);
+    controller.saveRatings(this->changedRatings, this->defaultRating);
 
-    if (this->defaultRating != this->savedDefaultRating) {
-      controller.saveDefaultRating(this->defaultRating);
-    }
-
-    controller.source = "";
+    controller.source = Catalog::NONE;
     tsl::goBack();
     return true;
   }
   return false;
-}
\ No newline at end of file
+}
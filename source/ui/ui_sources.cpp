@@ -3,18 +3,18 @@
 #include "ui/ui_ratings.h"
 
 #include <string>
-#include <vector>
 
 #include "controller.h"
 
 GuiSources::GuiSources() {}
 
 tsl::elm::Element* GuiSources::createUI() {
-  auto frame = new tsl::elm::OverlayFrame("State Alchemist", controller.group);
+  const Catalog& catalog = controller.getCatalog();
+  auto frame = new tsl::elm::OverlayFrame("State Alchemist", std::string(catalog.groupName(controller.group)));
 
   auto list = new tsl::elm::List();
 
-  std::vector<std::string> sources = controller.loadSources(true);
+  Catalog::IdRange sources = catalog.sourcesOf(controller.group);
 
   // For when the group is empty for some reason:
   if (sources.empty()) {
@@ -25,8 +25,8 @@ tsl::elm::Element* GuiSources::createUI() {
   list->addItem(new tsl::elm::CategoryHeader("\uE0E0 View Mods    |    \uE0E3 View Mod Probabilities"));
 
   // List all of the group's sources:
-  for (const std::string &source : sources) {
-    auto *item = new tsl::elm::ListItem(source);
+  for (u32 source : sources) {
+    auto *item = new tsl::elm::ListItem(std::string(catalog.sourceName(source)));
 
     item->setClickListener([this, source](u64 keys) {
       if (keys & HidNpadButton_A) {
@@ -59,7 +59,7 @@ bool GuiSources::handleInput(
   HidAnalogStickState joyStickPosRight
 ) {
   if (keysDown & HidNpadButton_B) {
-    controller.group = "";
+    controller.group = Catalog::NONE;
     tsl::goBack();
     return true;
   }
@@ -0,0 +1,276 @@
+#include "ui/virtual_list.h"
+
+#include <algorithm>
+
+// Frames up/down has to be held before the selection starts repeating, and frames between each repeat:
+static const u32 REPEAT_DELAY = 20;
+static const u32 REPEAT_INTERVAL = 4;
+
+/**
+ * @param labelRow Leave empty for rows without a header above them
+ */
+VirtualList::VirtualList(u32 rowCount, RowFactory createRow, RowBinder bindRow, RowLabel labelRow)
+  : rowCount(rowCount), createRow(std::move(createRow)), bindRow(std::move(bindRow)), labelRow(std::move(labelRow)) {}
+
+VirtualList::~VirtualList() {
+  for (tsl::elm::Element* header : this->headers) {
+    delete header;
+  }
+  for (tsl::elm::Element* slot : this->slots) {
+    delete slot;
+  }
+  for (tsl::elm::CategoryHeader* label : this->slotLabels) {
+    delete label;
+  }
+}
+
+/**
+ * Adds an element above the rows (such as a header), which scrolls along with them
+ */
+void VirtualList::addHeader(tsl::elm::Element* element) {
+  element->setParent(this);
+  element->invalidate();
+
+  this->headers.push_back(element);
+  this->headersHeight += element->getHeight();
+}
+
+/**
+ * Gets the row an element is currently showing
+ */
+u32 VirtualList::rowOf(tsl::elm::Element* element) const {
+  auto slot = std::find(this->slots.begin(), this->slots.end(), element);
+  return this->slotRows[slot - this->slots.begin()];
+}
+
+/**
+ * Gets the element showing a row (nullptr if it isn't on screen)
+ */
+tsl::elm::Element* VirtualList::elementFor(u32 row) const {
+  if (this->slots.empty()) { return nullptr; }
+
+  u32 slot = row % this->slots.size();
+  return this->slotRows[slot] == row ? this->slots[slot] : nullptr;
+}
+
+/**
+ * Fills in every row on screen again (after the data behind them changes)
+ */
+void VirtualList::refresh() {
+  for (u32 slot = 0; slot < this->slots.size(); slot++) {
+    if (this->slotRows[slot] >= this->rowCount) { continue; }
+
+    this->bindRow(this->slots[slot], this->slotRows[slot]);
+    if (this->labelRow) {
+      this->slotLabels[slot]->setText(this->labelRow(this->slotRows[slot]));
+    }
+  }
+}
+
+void VirtualList::draw(tsl::gfx::Renderer* renderer) {
+  s32 top = this->getY();
+  s32 bottom = top + this->getHeight();
+
+  renderer->enableScissoring(this->getX(), top, this->getWidth(), this->getHeight());
+
+  for (tsl::elm::Element* header : this->headers) {
+    if (header->getY() + header->getHeight() > top && header->getY() < bottom) {
+      header->frame(renderer);
+    }
+  }
+
+  for (u32 row = this->firstRow; row < this->endRow; row++) {
+    u32 slot = row % this->slots.size();
+
+    if (this->labelRow) {
+      this->slotLabels[slot]->frame(renderer);
+    }
+    this->slots[slot]->frame(renderer);
+  }
+
+  renderer->disableScissoring();
+
+  // Scroll bar, for when there's more than fits on screen:
+  s32 totalHeight = this->headersHeight + this->rowCount * this->rowHeight;
+  if (totalHeight > this->getHeight()) {
+    s32 barHeight = std::max<s32>(this->getHeight() * this->getHeight() / totalHeight, 8);
+    s32 barY = top + (this->getHeight() - barHeight) * this->scroll / (totalHeight - this->getHeight());
+    renderer->drawRect(this->getX() + this->getWidth() + 10, barY, 5, barHeight, renderer->a(tsl::style::color::ColorHandle));
+  }
+}
+
+void VirtualList::layout(u16 parentX, u16 parentY, u16 parentWidth, u16 parentHeight) {
+  if (this->slots.empty()) {
+    this->createSlots();
+  }
+
+  this->placeRows();
+}
+
+tsl::elm::Element* VirtualList::requestFocus(tsl::elm::Element* oldFocus, tsl::FocusDirection direction) {
+  return this->rowCount == 0 ? nullptr : this;
+}
+
+void VirtualList::setFocused(bool focused) {
+  this->focused = focused;
+
+  if (tsl::elm::Element* element = this->cursorElement()) {
+    element->setFocused(focused);
+  }
+}
+
+/**
+ * The selected row's element is highlighted instead of the whole list
+ */
+void VirtualList::drawHighlight(tsl::gfx::Renderer* renderer) {}
+
+bool VirtualList::onClick(u64 keys) {
+  tsl::elm::Element* element = this->cursorElement();
+  return element != nullptr && element->onClick(keys);
+}
+
+bool VirtualList::handleInput(
+  u64 keysDown,
+  u64 keysHeld,
+  const HidTouchState &touchPos,
+  HidAnalogStickState joyStickPosLeft,
+  HidAnalogStickState joyStickPosRight
+) {
+  u64 keys = keysDown;
+
+  // Keep moving while up/down is held:
+  if (keysHeld & (HidNpadButton_AnyUp | HidNpadButton_AnyDown)) {
+    this->heldFrames++;
+    if (this->heldFrames > REPEAT_DELAY && this->heldFrames % REPEAT_INTERVAL == 0) {
+      keys |= keysHeld;
+    }
+  } else {
+    this->heldFrames = 0;
+  }
+
+  if ((keys & HidNpadButton_AnyUp) && this->cursor > 0) {
+    this->moveCursor(this->cursor - 1);
+    return true;
+  }
+  if ((keys & HidNpadButton_AnyDown) && this->cursor + 1 < this->rowCount) {
+    this->moveCursor(this->cursor + 1);
+    return true;
+  }
+
+  // Anything else (such as moving a slider) goes to the selected row:
+  tsl::elm::Element* element = this->cursorElement();
+  return element != nullptr && element->handleInput(keysDown, keysHeld, touchPos, joyStickPosLeft, joyStickPosRight);
+}
+
+/**
+ * Creates as many slots as it takes to fill the list's height
+ */
+void VirtualList::createSlots() {
+  tsl::elm::Element* first = this->createRow();
+  first->setParent(this);
+  first->setBoundaries(this->getX(), this->getY(), this->getWidth(), 0);
+  first->invalidate();
+  this->rowHeight = first->getHeight();
+
+  if (this->labelRow) {
+    auto* label = new tsl::elm::CategoryHeader("");
+    label->setParent(this);
+    label->setBoundaries(this->getX(), this->getY(), this->getWidth(), 0);
+    label->invalidate();
+    this->labelHeight = label->getHeight();
+    this->rowHeight += this->labelHeight;
+    this->slotLabels.push_back(label);
+  }
+
+  // Enough for a screen of rows, plus one for a row partly cut off at the top & bottom:
+  u32 slotCount = std::min<u32>(this->getHeight() / std::max<s32>(this->rowHeight, 1) + 2, std::max<u32>(this->rowCount, 1));
+
+  this->slots.push_back(first);
+  while (this->slots.size() < slotCount) {
+    tsl::elm::Element* element = this->createRow();
+    element->setParent(this);
+    this->slots.push_back(element);
+
+    if (this->labelRow) {
+      auto* label = new tsl::elm::CategoryHeader("");
+      label->setParent(this);
+      this->slotLabels.push_back(label);
+    }
+  }
+
+  // No slot has been filled in yet:
+  this->slotRows.assign(slotCount, this->rowCount);
+}
+
+/**
+ * Scrolls so the selected row is on screen, then moves each slot to where its row is (filling it in if it changed)
+ */
+void VirtualList::placeRows() {
+  if (this->rowCount == 0) { return; }
+
+  // The first row also shows the headers above it:
+  s32 cursorTop = this->cursor == 0 ? 0 : this->headersHeight + this->cursor * this->rowHeight;
+  s32 cursorBottom = this->headersHeight + (this->cursor + 1) * this->rowHeight;
+  if (cursorTop < this->scroll) {
+    this->scroll = cursorTop;
+  } else if (cursorBottom > this->scroll + this->getHeight()) {
+    this->scroll = cursorBottom - this->getHeight();
+  }
+
+  s32 y = this->getY() - this->scroll;
+  for (tsl::elm::Element* header : this->headers) {
+    header->setBoundaries(this->getX(), y, this->getWidth(), header->getHeight());
+    header->invalidate();
+    y += header->getHeight();
+  }
+
+  this->firstRow = std::max<s32>(this->scroll - this->headersHeight, 0) / this->rowHeight;
+  this->endRow = std::min<u32>(this->firstRow + this->slots.size(), this->rowCount);
+
+  for (u32 row = this->firstRow; row < this->endRow; row++) {
+    u32 slot = row % this->slots.size();
+    tsl::elm::Element* element = this->slots[slot];
+
+    if (this->slotRows[slot] != row) {
+      // Only the selected row's element is focused:
+      if (this->slotRows[slot] == this->cursor || row == this->cursor) {
+        element->setFocused(this->focused && row == this->cursor);
+      }
+
+      this->slotRows[slot] = row;
+      this->bindRow(element, row);
+      if (this->labelRow) {
+        this->slotLabels[slot]->setText(this->labelRow(row));
+      }
+    }
+
+    s32 rowY = y + row * this->rowHeight;
+    if (this->labelRow) {
+      this->slotLabels[slot]->setBoundaries(this->getX(), rowY, this->getWidth(), this->labelHeight);
+      this->slotLabels[slot]->invalidate();
+    }
+
+    element->setBoundaries(this->getX(), rowY + this->labelHeight, this->getWidth(), this->rowHeight - this->labelHeight);
+    element->invalidate();
+  }
+}
+
+/**
+ * Selects another row, moving the focus to its element
+ */
+void VirtualList::moveCursor(u32 row) {
+  if (tsl::elm::Element* element = this->cursorElement()) {
+    element->setFocused(false);
+  }
+
+  this->cursor = row;
+  this->placeRows();
+
+  if (tsl::elm::Element* element = this->cursorElement()) {
+    element->setFocused(this->focused);
+  }
+}
+
+tsl::elm::Element* VirtualList::cursorElement() const {
+  return this->elementFor(this->cursor);
+}
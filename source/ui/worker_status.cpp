@@ -0,0 +1,100 @@
+#include "ui/worker_status.h"
+
+#include "ui/ui_error.h"
+
+/**
+ * @param itemName What the task changes one at a time (such as "mod")
+ * @param finishedText Shown once the task has done everything
+ * @param changedText What happened to the items that were done before the task was stopped (such as "disabled")
+ */
+WorkerStatus::WorkerStatus(tsl::Gui* gui, std::string itemName, std::string finishedText, std::string changedText)
+  : gui(gui), itemName(std::move(itemName)), finishedText(std::move(finishedText)), changedText(std::move(changedText)) {}
+
+/**
+ * Starts the task, replacing everything in the list with its status
+ */
+void WorkerStatus::start(tsl::elm::List* items, Worker::Task task) {
+  this->worker.start(std::move(task));
+
+  this->gui->removeFocus();
+  this->items = items;
+  this->items->clear();
+
+  // Show how far along it is until it finishes (see update())
+  this->status = new tsl::elm::ListItem("Working...");
+  this->status->setClickListener([this](u64 keys) {
+    if (keys & HidNpadButton_A) {
+      this->worker.cancel();
+      return true;
+    }
+    return false;
+  });
+
+  this->items->addItem(this->status);
+  this->items->addItem(new tsl::elm::CategoryHeader("Press A to stop after the current " + this->itemName));
+}
+
+/**
+ * Shows how far along the task is, then what was done once it's finished
+ */
+void WorkerStatus::update() {
+  if (this->status == nullptr) { return; }
+
+  const Progress& progress = this->worker.getProgress();
+
+  // The worker can't change screens itself, so its error is shown from here:
+  if (progress.failed) {
+    GuiError::fail(progress.error);
+  }
+
+  if (this->worker.isFinished()) {
+    this->showFinished();
+    return;
+  }
+
+  this->status->setValue(
+    std::to_string(progress.done) + "/" + std::to_string(progress.total)
+    + " (" + std::to_string(progress.files) + " files)",
+    progress.cancelled
+  );
+}
+
+/**
+ * Asks the task to stop after the current item if it's running
+ *
+ * Returns false if it isn't running
+ */
+bool WorkerStatus::stop() {
+  if (!this->worker.isRunning()) { return false; }
+
+  this->worker.cancel();
+  return true;
+}
+
+/**
+ * Replaces the list with what was done once the worker is finished
+ */
+void WorkerStatus::showFinished() {
+  const Progress& progress = this->worker.getProgress();
+
+  this->gui->removeFocus(this->status);
+  this->items->clear();
+  this->status = nullptr;
+
+  auto* finished = new tsl::elm::ListItem(progress.cancelled ? "Stopped" : this->finishedText);
+  finished->setClickListener([](u64 keys) {
+    if (keys & HidNpadButton_A) {
+      tsl::goBack();
+      return true;
+    }
+    return false;
+  });
+
+  this->items->addItem(finished);
+  if (progress.cancelled) {
+    this->items->addItem(new tsl::elm::CategoryHeader(
+      std::to_string(progress.done) + " of " + std::to_string(progress.total) + " " + this->itemName + "s were " + this->changedText
+    ));
+  }
+  this->items->addItem(new tsl::elm::CategoryHeader("Please relaunch game now"));
+}
@@ -0,0 +1,77 @@
+#include "worker.h"
+
+#include "constants.h"
+#include "ui/ui_error.h"
+
+thread_local Worker* Worker::current = nullptr;
+
+/**
+ * Waits for the task to finish if it's still running
+ */
+Worker::~Worker() {
+  if (this->started) {
+    threadWaitForExit(&this->thread);
+    threadClose(&this->thread);
+  }
+}
+
+void Worker::start(Task task) {
+  this->task = std::move(task);
+  this->started = true;
+
+  GuiError::tryResult(
+    threadCreate(&this->thread, Worker::run, this, nullptr, WORKER_STACK_SIZE, WORKER_PRIORITY, -2),
+    "threadCreate"
+  );
+  GuiError::tryResult(threadStart(&this->thread), "threadStart");
+}
+
+bool Worker::isRunning() const {
+  return this->started && !this->finished;
+}
+
+/**
+ * Checks if a task was started and has finished (whether or not it was cancelled)
+ */
+bool Worker::isFinished() const {
+  return this->started && this->finished;
+}
+
+/**
+ * Asks the task to stop as soon as it safely can
+ */
+void Worker::cancel() {
+  this->progress.cancelled = true;
+}
+
+const Progress& Worker::getProgress() const {
+  return this->progress;
+}
+
+/**
+ * Checks if this is a worker's thread (which must never touch the menu)
+ */
+bool Worker::isWorkerThread() {
+  return current != nullptr;
+}
+
+/**
+ * Stops the task running on this thread because of an error, leaving the message in its progress for the menu to show
+ *
+ * Nothing is unwound: like an error on the UI thread, it's followed by stopping Mod Alchemist, and the journal
+ * finishes whatever was left half-done the next time it's opened.
+ */
+void Worker::fail(const std::string& message) {
+  current->progress.error = message;
+  current->progress.failed = true;
+  current->finished = true;
+
+  threadExit();
+}
+
+void Worker::run(void* worker) {
+  Worker* self = static_cast<Worker*>(worker);
+  current = self;
+  self->task(self->progress);
+  self->finished = true;
+}